@@ -100,9 +100,8 @@ void CAPRSWriterThread::entry()
 			//LogMessage("Loop the APRS Writer thread");
 			::sleep(1);
 
-				if (!m_queue.isEmpty()){
-					char* p = NULL;
-					m_queue.getData(&p, 1U);
+				char* p = NULL;
+				if (m_queue.pop(p)) {
 
 					LogMessage("APRS ==> %s", p);
 
@@ -136,11 +135,9 @@ void CAPRSWriterThread::entry()
 
 			}
 
-		while (!m_queue.isEmpty()) {
-			char* p = NULL;
-			m_queue.getData(&p, 1U);
+		char* p = NULL;
+		while (m_queue.pop(p))
 			delete[] p;
-		}
 	}
 	catch (std::exception& e) {
 		LogError("Exception raised in the APRS Writer thread - \"%s\"", e.what());
@@ -169,7 +166,8 @@ void CAPRSWriterThread::write(const char* data)
 	char* p = new char[len + 5U];
 	::strcpy(p, data);
 
-	m_queue.addData(&p, 1U);
+	if (!m_queue.push(p))
+		delete[] p;
 }
 
 bool CAPRSWriterThread::isConnected() const
@@ -20,7 +20,7 @@
 #define	APRSWriterThread_H
 
 #include "TCPSocket.h"
-#include "RingBuffer.h"
+#include "SPSCRingBuffer.h"
 #include "Timer.h"
 #include "Thread.h"
 
@@ -52,7 +52,7 @@ private:
 	std::string            m_username;
 	std::string            m_password;
 	CTCPSocket             m_socket;
-	CRingBuffer<char*>     m_queue;
+	CSPSCRingBuffer<char*> m_queue;
 	bool                   m_exit;
 	bool                   m_connected;
 	ReadAPRSFrameCallback  m_APRSReadCallback;
@@ -0,0 +1,284 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "BinaryCache.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+const uint32_t CACHE_BYTE_ORDER = 0x01020304U;
+
+CBinaryCache::CBinaryCache() :
+m_map(NULL),
+m_size(0U)
+#if defined(_WIN32) || defined(_WIN64)
+,
+m_file(INVALID_HANDLE_VALUE),
+m_mapping(NULL)
+#endif
+{
+}
+
+CBinaryCache::~CBinaryCache()
+{
+	close();
+}
+
+bool CBinaryCache::open(const std::string& file, const char* magic, uint32_t version, uint32_t kind, const std::string& source)
+{
+	assert(magic != NULL);
+	assert(m_map == NULL);
+
+	CCacheHeader wanted;
+	if (!header(wanted, magic, version, kind, source))
+		return false;
+
+#if defined(_WIN32) || defined(_WIN64)
+	m_file = ::CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (m_file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!::GetFileSizeEx(m_file, &size) || size.QuadPart < LONGLONG(sizeof(CCacheHeader))) {
+		close();
+		return false;
+	}
+
+	m_mapping = ::CreateFileMapping(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_mapping == NULL) {
+		close();
+		return false;
+	}
+
+	m_map = (const unsigned char*)::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (m_map == NULL) {
+		close();
+		return false;
+	}
+
+	m_size = size_t(size.QuadPart);
+#else
+	int fd = ::open(file.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(CCacheHeader)) {
+		::close(fd);
+		return false;
+	}
+
+	void* map = ::mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+
+	if (map == MAP_FAILED)
+		return false;
+
+	m_map  = (const unsigned char*)map;
+	m_size = st.st_size;
+#endif
+
+	const CCacheHeader* found = (const CCacheHeader*)m_map;
+	if (::memcmp(found->m_magic, wanted.m_magic, CACHE_MAGIC_LENGTH) != 0 ||
+		found->m_version    != wanted.m_version    ||
+		found->m_order      != wanted.m_order      ||
+		found->m_kind       != wanted.m_kind       ||
+		found->m_sourceSize != wanted.m_sourceSize ||
+		found->m_sourceTime != wanted.m_sourceTime) {
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+const CCacheHeader* CBinaryCache::header() const
+{
+	assert(m_map != NULL);
+
+	return (const CCacheHeader*)m_map;
+}
+
+const unsigned char* CBinaryCache::data() const
+{
+	assert(m_map != NULL);
+
+	return m_map + sizeof(CCacheHeader);
+}
+
+size_t CBinaryCache::length() const
+{
+	return m_map != NULL ? m_size - sizeof(CCacheHeader) : 0U;
+}
+
+void CBinaryCache::close()
+{
+#if defined(_WIN32) || defined(_WIN64)
+	if (m_map != NULL)
+		::UnmapViewOfFile(m_map);
+
+	if (m_mapping != NULL)
+		::CloseHandle(m_mapping);
+
+	if (m_file != INVALID_HANDLE_VALUE)
+		::CloseHandle(m_file);
+
+	m_mapping = NULL;
+	m_file    = INVALID_HANDLE_VALUE;
+#else
+	if (m_map != NULL)
+		::munmap((void*)m_map, m_size);
+#endif
+
+	m_map  = NULL;
+	m_size = 0U;
+}
+
+bool CBinaryCache::header(CCacheHeader& header, const char* magic, uint32_t version, uint32_t kind, const std::string& source)
+{
+	assert(magic != NULL);
+
+	::memset(&header, 0x00, sizeof(CCacheHeader));
+	::memcpy(header.m_magic, magic, ::strlen(magic) < CACHE_MAGIC_LENGTH ? ::strlen(magic) : CACHE_MAGIC_LENGTH);
+
+	header.m_version = version;
+	header.m_order   = CACHE_BYTE_ORDER;
+	header.m_kind    = kind;
+
+	if (source.empty())
+		return true;
+
+#if defined(_WIN32) || defined(_WIN64)
+	struct _stat64 st;
+	if (::_stat64(source.c_str(), &st) != 0)
+		return false;
+#else
+	struct stat st;
+	if (::stat(source.c_str(), &st) != 0)
+		return false;
+#endif
+
+	header.m_sourceSize = st.st_size;
+	header.m_sourceTime = st.st_mtime;
+
+	return true;
+}
+
+bool CBinaryCache::write(const std::string& file, const CCacheHeader& header, const std::vector<CCacheBlock>& blocks)
+{
+	std::string temp;
+	FILE* fp = openTemp(file, temp, "wb");
+	if (fp == NULL) {
+		LogWarning("Cannot open the cache file - %s", temp.c_str());
+		return false;
+	}
+
+	::fwrite(&header, sizeof(CCacheHeader), 1U, fp);
+
+	for (std::vector<CCacheBlock>::const_iterator it = blocks.begin(); it != blocks.end(); ++it) {
+		if (it->m_length > 0U)
+			::fwrite(it->m_data, 1U, it->m_length, fp);
+	}
+
+	if (!replace(fp, temp, file)) {
+		LogWarning("Cannot write the cache file - %s", file.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+FILE* CBinaryCache::openTemp(const std::string& file, std::string& temp, const char* mode)
+{
+	assert(mode != NULL);
+
+	temp = file + ".tmp";
+
+#if defined(_WIN32) || defined(_WIN64)
+	return ::fopen(temp.c_str(), mode);
+#else
+	// A new file with a name that cannot be guessed, so that in a shared
+	// directory nobody can have put a link in its place beforehand
+	std::vector<char> name(file.begin(), file.end());
+	name.insert(name.end(), ".XXXXXX", ".XXXXXX" + 8U);
+
+	int fd = ::mkstemp(&name[0]);
+	if (fd < 0)
+		return NULL;
+
+	temp = &name[0];
+
+	FILE* fp = ::fdopen(fd, mode);
+	if (fp == NULL) {
+		::close(fd);
+		::remove(temp.c_str());
+	}
+
+	return fp;
+#endif
+}
+
+bool CBinaryCache::replace(FILE* fp, const std::string& temp, const std::string& file)
+{
+	assert(fp != NULL);
+
+	bool ret = ::ferror(fp) == 0;
+	ret = ::fclose(fp) == 0 && ret;
+	if (!ret) {
+		::remove(temp.c_str());
+		return false;
+	}
+
+#if defined(_WIN32) || defined(_WIN64)
+	// rename() will not replace an existing file here
+	::remove(file.c_str());
+#endif
+
+	if (::rename(temp.c_str(), file.c_str()) != 0) {
+		::remove(temp.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+std::string CBinaryCache::fileName(const std::string& directory, const std::string& source, const char* suffix)
+{
+	assert(suffix != NULL);
+
+	std::string::size_type n = source.find_last_of("/\\");
+	std::string base = n == std::string::npos ? source : source.substr(n + 1U);
+
+#if defined(_WIN32) || defined(_WIN64)
+	return directory + "\\" + base + "." + suffix;
+#else
+	return directory + "/" + base + "." + suffix;
+#endif
+}
@@ -0,0 +1,104 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#if !defined(BinaryCache_H)
+#define	BinaryCache_H
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+const unsigned int CACHE_MAGIC_LENGTH = 8U;
+
+// The start of every cache file. The source size and time say which copy of
+// the text file it was made from, and the byte order marker stops a file
+// made on another machine from being read. The rest of the header is for the
+// owner of the file to use.
+struct CCacheHeader {
+	char     m_magic[CACHE_MAGIC_LENGTH];
+	uint32_t m_version;
+	uint32_t m_order;
+	uint64_t m_sourceSize;
+	int64_t  m_sourceTime;
+	uint32_t m_kind;
+	uint32_t m_count;
+	uint32_t m_param;
+	uint32_t m_poolSize;
+};
+
+// A block of a cache file to be written, after the header
+struct CCacheBlock {
+	const void* m_data;
+	size_t      m_length;
+};
+
+// The parsed form of a text list, kept in a file that is mapped rather than
+// read, so that a restart can use it straight away as long as the text file
+// has not changed since.
+class CBinaryCache {
+public:
+	CBinaryCache();
+	~CBinaryCache();
+
+	// False when there is no cache, or it is not for this copy of the source.
+	// A file that stands on its own, made with no source, is opened with none.
+	bool open(const std::string& file, const char* magic, uint32_t version, uint32_t kind, const std::string& source);
+
+	const CCacheHeader* header() const;
+
+	// What follows the header
+	const unsigned char* data() const;
+	size_t length() const;
+
+	void close();
+
+	// A header for the current copy of the source, false if it cannot be found,
+	// or one with no source when it is empty
+	static bool header(CCacheHeader& header, const char* magic, uint32_t version, uint32_t kind, const std::string& source);
+
+	// Written to a temporary file and renamed, so a reader never sees half of it
+	static bool write(const std::string& file, const CCacheHeader& header, const std::vector<CCacheBlock>& blocks);
+
+	// For any file written that way. openTemp() makes the temporary file next
+	// to it, where possible with a name that cannot be guessed, and gives its
+	// name in temp. replace() closes it and renames it over the file, and on
+	// failure removes it.
+	static FILE* openTemp(const std::string& file, std::string& temp, const char* mode);
+	static bool replace(FILE* fp, const std::string& temp, const std::string& file);
+
+	// The cache file in the directory for the source file
+	static std::string fileName(const std::string& directory, const std::string& source, const char* suffix);
+
+private:
+	const unsigned char* m_map;
+	size_t               m_size;
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE               m_file;
+	HANDLE               m_mapping;
+#endif
+
+	CBinaryCache(const CBinaryCache&);
+	CBinaryCache& operator=(const CBinaryCache&);
+};
+
+#endif
@@ -41,7 +41,8 @@ enum SECTION {
   SECTION_FCS_NETWORK,
   SECTION_DMR_NETWORK,  
   SECTION_MOBILE_GPS,
-  SECTION_REMOTE_COMMANDS
+  SECTION_REMOTE_COMMANDS,
+  SECTION_METRICS
 };
 
 CConf::CConf(const std::string& file) :
@@ -90,10 +91,12 @@ m_networkInactivityTimeout(0U),
 m_networkDebug(false),
 m_networkNoChange(false),
 m_NetworkReloadTime(0U),
+m_networkCachePath(),
 m_ysfNetworkEnabled(false),
 m_ysfNetworkOptions(""),
 m_ysfNetworkPort(0U),
 m_ysfNetworkHosts(""),
+m_ysfNetworkHostsCache(""),
 m_ysfNetworkParrotAddress("127.0.0.1"),
 m_ysfNetworkParrotPort(42012U),
 m_ysfNetworkYSF2NXDNAddress("127.0.0.1"),
@@ -128,7 +131,10 @@ m_remoteCommandsEnabled(false),
 m_remoteCommandsPort(6073U),
 m_newspath("/tmp/news"),
 m_beaconpath("/usr/local/sbin/beacon.amb"),
-m_ysfDGID(0U)
+m_ysfDGID(0U),
+m_metricsEnabled(false),
+m_metricsFile(),
+m_metricsInterval(15U)
 {
 }
 
@@ -172,6 +178,8 @@ bool CConf::read()
 		  section = SECTION_MOBILE_GPS;	 
 	  else if (::strncmp(buffer, "[Remote Commands]", 17U) == 0)
 		  section = SECTION_REMOTE_COMMANDS;		   
+	  else if (::strncmp(buffer, "[Metrics]", 9U) == 0)
+		  section = SECTION_METRICS;
 	  else
 	  	  section = SECTION_NONE;
 
@@ -295,6 +303,8 @@ bool CConf::read()
 			m_networkDebug = ::atoi(value) == 1;
 		else if (::strcmp(key, "ReloadTime") == 0)
 			m_NetworkReloadTime = (unsigned int)::atoi(value);		
+		else if (::strcmp(key, "CachePath") == 0)
+			m_networkCachePath = value;
 		else if (::strcmp(key, "NoChange") == 0)
 			m_networkNoChange = ::atoi(value) == 1;		
 		else if (::strcmp(key, "Jitter") == 0)
@@ -312,6 +322,8 @@ bool CConf::read()
 			m_ysfNetworkPort = (unsigned int)::atoi(value);
 		else if (::strcmp(key, "Hosts") == 0)
 			m_ysfNetworkHosts = value;
+		else if (::strcmp(key, "HostsCache") == 0)
+			m_ysfNetworkHostsCache = value;
 		else if (::strcmp(key, "ParrotAddress") == 0)
 			m_ysfNetworkParrotAddress = value;
 		else if (::strcmp(key, "ParrotPort") == 0)
@@ -386,6 +398,13 @@ bool CConf::read()
 			m_remoteCommandsEnabled = ::atoi(value) == 1;
 		else if (::strcmp(key, "Port") == 0)
 			m_remoteCommandsPort = (unsigned int)::atoi(value);
+	} else if (section == SECTION_METRICS) {
+		if (::strcmp(key, "Enable") == 0)
+			m_metricsEnabled = ::atoi(value) == 1;
+		else if (::strcmp(key, "File") == 0)
+			m_metricsFile = value;
+		else if (::strcmp(key, "Interval") == 0)
+			m_metricsInterval = (unsigned int)::atoi(value);
 	}
   }
 
@@ -635,11 +654,21 @@ std::string CConf::getYSFNetworkHosts() const
 	return m_ysfNetworkHosts;
 }
 
+std::string CConf::getYSFNetworkHostsCache() const
+{
+	return m_ysfNetworkHostsCache;
+}
+
 unsigned int CConf::getNetworkReloadTime() const
 {
 	return m_NetworkReloadTime;
 }
 
+std::string CConf::getNetworkCachePath() const
+{
+	return m_networkCachePath;
+}
+
 std::string CConf::getYSFNetworkParrotAddress() const
 {
 	return m_ysfNetworkParrotAddress;
@@ -831,6 +860,21 @@ unsigned int CConf::getRemoteCommandsPort() const
 	return m_remoteCommandsPort;
 }
 
+bool CConf::getMetricsEnabled() const
+{
+	return m_metricsEnabled;
+}
+
+std::string CConf::getMetricsFile() const
+{
+	return m_metricsFile;
+}
+
+unsigned int CConf::getMetricsInterval() const
+{
+	return m_metricsInterval;
+}
+
 std::string CConf::getNewsPath() const
 {
 	return m_newspath;
@@ -87,6 +87,7 @@ public:
   bool         getNetworkDebug() const;
   bool 		     getNetworkNoChange() const;
   unsigned int getNetworkReloadTime() const;  
+  std::string  getNetworkCachePath() const;
 
   // The YSF Network section
   bool         getYSFNetworkEnabled() const;
@@ -94,6 +95,7 @@ public:
   std::string  getYSFNetworkOptions() const;
   unsigned int getYSFNetworkPort() const;
   std::string  getYSFNetworkHosts() const;
+  std::string  getYSFNetworkHostsCache() const;
   std::string  getYSFNetworkParrotAddress() const;
   unsigned int getYSFNetworkParrotPort() const;
   std::string  getYSFNetworkYSF2DMRAddress() const;
@@ -149,6 +151,11 @@ public:
   unsigned int getStartupDGID() const;
   unsigned int getJitter() const;
 
+  // The Metrics section
+  bool         getMetricsEnabled() const;
+  std::string  getMetricsFile() const;
+  unsigned int getMetricsInterval() const;
+
 private:
   std::string  m_file;
   std::string  m_callsign;
@@ -200,12 +207,14 @@ private:
   bool         m_networkDebug;
   bool		   m_networkNoChange;
   unsigned int m_NetworkReloadTime;
+  std::string  m_networkCachePath;
 
   bool         m_ysfNetworkEnabled;
   unsigned int m_ysfStartup; 
   std::string  m_ysfNetworkOptions;
   unsigned int m_ysfNetworkPort;
   std::string  m_ysfNetworkHosts;
+  std::string  m_ysfNetworkHostsCache;
   std::string  m_ysfNetworkParrotAddress;
   unsigned int m_ysfNetworkParrotPort;
   std::string  m_ysfNetworkYSF2NXDNAddress;
@@ -252,6 +261,10 @@ private:
   std::string  m_beaconpath; 
   unsigned int m_ysfDGID;
   unsigned int m_jitter;
+
+  bool         m_metricsEnabled;
+  std::string  m_metricsFile;
+  unsigned int m_metricsInterval;
 };
 
 #endif
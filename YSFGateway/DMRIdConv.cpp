@@ -0,0 +1,53 @@
+/*
+ *   Copyright (C) 2026 by agent
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Turns a DMR Id text file, such as DMRIds.dat, into the database that the
+// gateway maps in place of it. The [DMR Network] File setting may then name
+// the database, and loading it, or reloading it after the next conversion,
+// involves no parsing at all.
+
+#include "DMRIdTable.h"
+#include "Log.h"
+
+#include <cstdio>
+
+int main(int argc, char** argv)
+{
+	if (argc != 3) {
+		::fprintf(stderr, "Usage: DMRIdConv <DMRIds.dat> <DMRIds.db>\n");
+		return 1;
+	}
+
+	::LogInitialise(".", "DMRIdConv", 0U, 2U);
+
+	CDMRIdTable table;
+
+	bool ret = table.load(argv[1], std::string());
+	if (!ret)
+		::fprintf(stderr, "DMRIdConv: no Ids in %s\n", argv[1]);
+
+	if (ret) {
+		ret = table.save(argv[2]);
+		if (ret)
+			::fprintf(stdout, "Wrote %u Ids to %s\n", table.size(), argv[2]);
+	}
+
+	::LogFinalise();
+
+	return ret ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "DMRIdTable.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <unordered_map>
+
+const char     CACHE_MAGIC[] = "YSFGWDID";
+const uint32_t CACHE_VERSION = 2U;
+
+const uint32_t KIND_CACHE    = 0U;
+const uint32_t KIND_DATABASE = 1U;
+
+template <class T> struct CIdOrder {
+	bool operator()(const T& a, const T& b) const
+	{
+		return a.m_id < b.m_id;
+	}
+};
+
+template <class T> struct CNameOrder {
+	const char* m_names;
+
+	bool operator()(const T& a, const T& b) const
+	{
+		return ::strcmp(m_names + a.m_name, m_names + b.m_name) < 0;
+	}
+};
+
+CDMRIdTable::CDMRIdTable() :
+m_names(),
+m_ids(),
+m_cs(),
+m_cache(),
+m_namePtr(NULL),
+m_idPtr(NULL),
+m_csPtr(NULL),
+m_idCount(0U),
+m_csCount(0U),
+m_poolSize(0U)
+{
+}
+
+CDMRIdTable::~CDMRIdTable()
+{
+}
+
+bool CDMRIdTable::load(const std::string& filename, const std::string& cacheFile)
+{
+	assert(m_idCount == 0U);
+
+	// A database made by save() needs nothing else
+	if (attach(filename, KIND_DATABASE, std::string()))
+		return true;
+
+	if (!cacheFile.empty() && attach(cacheFile, KIND_CACHE, filename))
+		return true;
+
+	// Taken first, so that a change while the file is read makes the cache stale
+	CCacheHeader header;
+	bool cache = !cacheFile.empty() && CBinaryCache::header(header, CACHE_MAGIC, CACHE_VERSION, KIND_CACHE, filename);
+
+	if (!read(filename))
+		return false;
+
+	if (cache)
+		write(header, cacheFile);
+
+	return true;
+}
+
+bool CDMRIdTable::save(const std::string& filename) const
+{
+	CCacheHeader header;
+	CBinaryCache::header(header, CACHE_MAGIC, CACHE_VERSION, KIND_DATABASE, std::string());
+
+	return write(header, filename);
+}
+
+bool CDMRIdTable::read(const std::string& filename)
+{
+	FILE* fp = ::fopen(filename.c_str(), "rt");
+	if (fp == NULL) {
+		LogWarning("Cannot open the Id lookup file - %s", filename.c_str());
+		return false;
+	}
+
+	// Each callsign is added to the pool once, at the index of its entry
+	std::unordered_map<std::string, unsigned int> names;
+
+	char buffer[100U];
+	while (::fgets(buffer, 100U, fp) != NULL) {
+		if (buffer[0U] == '#')
+			continue;
+
+		char* p1 = ::strtok(buffer, " \t\r\n");
+		char* p2 = ::strtok(NULL, " \t\r\n");
+
+		if (p1 != NULL && p2 != NULL) {
+			unsigned int id = (unsigned int)::atoi(p1);
+
+			for (char* p = p2; *p != 0x00; p++)
+				*p = ::toupper(*p);
+
+			std::pair<std::unordered_map<std::string, unsigned int>::iterator, bool> ret = names.insert(std::make_pair(std::string(p2), m_cs.size()));
+			if (ret.second) {
+				CNameEntry entry = {uint32_t(m_names.size()), id};
+				m_cs.push_back(entry);
+				m_names.insert(m_names.end(), p2, p2 + ::strlen(p2) + 1U);
+			} else {
+				// A later line for the same callsign replaces an earlier one
+				m_cs[ret.first->second].m_id = id;
+			}
+
+			CIdEntry entry = {id, m_cs[ret.first->second].m_name};
+			m_ids.push_back(entry);
+		}
+	}
+
+	::fclose(fp);
+
+	// A later line for the same Id replaces an earlier one
+	std::stable_sort(m_ids.begin(), m_ids.end(), CIdOrder<CIdEntry>());
+
+	std::vector<CIdEntry>::iterator out = m_ids.begin();
+	for (std::vector<CIdEntry>::const_iterator it = m_ids.begin(); it != m_ids.end(); ++it) {
+		if ((it + 1) != m_ids.end() && (it + 1)->m_id == it->m_id)
+			continue;
+
+		*out++ = *it;
+	}
+
+	m_ids.erase(out, m_ids.end());
+
+	CNameOrder<CNameEntry> order = {m_names.data()};
+	std::sort(m_cs.begin(), m_cs.end(), order);
+
+	m_namePtr = m_names.data();
+	m_idPtr   = m_ids.data();
+	m_csPtr   = m_cs.data();
+	m_idCount  = m_ids.size();
+	m_csCount  = m_cs.size();
+	m_poolSize = m_names.size();
+
+	return m_idCount > 0U;
+}
+
+bool CDMRIdTable::attach(const std::string& file, uint32_t kind, const std::string& source)
+{
+	if (!m_cache.open(file, CACHE_MAGIC, CACHE_VERSION, kind, source))
+		return false;
+
+	const CCacheHeader* header = m_cache.header();
+
+	unsigned int idCount  = header->m_count;
+	unsigned int csCount  = header->m_param;
+	unsigned int poolSize = header->m_poolSize;
+
+	size_t length = size_t(idCount) * sizeof(CIdEntry) + size_t(csCount) * sizeof(CNameEntry) + poolSize;
+	if (idCount == 0U || poolSize == 0U || m_cache.length() != length) {
+		LogWarning("Ignoring the damaged Id lookup file - %s", file.c_str());
+		m_cache.close();
+		return false;
+	}
+
+	const unsigned char* p = m_cache.data();
+
+	const CIdEntry*   ids   = (const CIdEntry*)p;
+	const CNameEntry* cs    = (const CNameEntry*)(p + idCount * sizeof(CIdEntry));
+	const char*       names = (const char*)(p + idCount * sizeof(CIdEntry) + csCount * sizeof(CNameEntry));
+
+	// Nothing in the file may point outside of the pool
+	bool valid = names[poolSize - 1U] == 0x00;
+	for (unsigned int i = 0U; valid && i < idCount; i++)
+		valid = ids[i].m_name < poolSize;
+	for (unsigned int i = 0U; valid && i < csCount; i++)
+		valid = cs[i].m_name < poolSize;
+
+	if (!valid) {
+		LogWarning("Ignoring the damaged Id lookup file - %s", file.c_str());
+		m_cache.close();
+		return false;
+	}
+
+	m_idPtr    = ids;
+	m_csPtr    = cs;
+	m_namePtr  = names;
+	m_idCount  = idCount;
+	m_csCount  = csCount;
+	m_poolSize = poolSize;
+
+	return true;
+}
+
+bool CDMRIdTable::write(CCacheHeader& header, const std::string& file) const
+{
+	if (m_idCount == 0U)
+		return false;
+
+	header.m_count    = m_idCount;
+	header.m_param    = m_csCount;
+	header.m_poolSize = m_poolSize;
+
+	std::vector<CCacheBlock> blocks;
+
+	CCacheBlock block;
+	block.m_data   = m_idPtr;
+	block.m_length = m_idCount * sizeof(CIdEntry);
+	blocks.push_back(block);
+
+	block.m_data   = m_csPtr;
+	block.m_length = m_csCount * sizeof(CNameEntry);
+	blocks.push_back(block);
+
+	block.m_data   = m_namePtr;
+	block.m_length = m_poolSize;
+	blocks.push_back(block);
+
+	return CBinaryCache::write(file, header, blocks);
+}
+
+const char* CDMRIdTable::findCS(unsigned int id) const
+{
+	unsigned int lo = 0U;
+	unsigned int hi = m_idCount;
+
+	while (lo < hi) {
+		unsigned int mid = (lo + hi) / 2U;
+
+		if (m_idPtr[mid].m_id < id)
+			lo = mid + 1U;
+		else
+			hi = mid;
+	}
+
+	if (lo < m_idCount && m_idPtr[lo].m_id == id)
+		return m_namePtr + m_idPtr[lo].m_name;
+
+	return NULL;
+}
+
+unsigned int CDMRIdTable::findID(const char* cs) const
+{
+	assert(cs != NULL);
+
+	unsigned int lo = 0U;
+	unsigned int hi = m_csCount;
+
+	while (lo < hi) {
+		unsigned int mid = (lo + hi) / 2U;
+
+		int cmp = ::strcmp(m_namePtr + m_csPtr[mid].m_name, cs);
+		if (cmp == 0)
+			return m_csPtr[mid].m_id;
+
+		if (cmp < 0)
+			lo = mid + 1U;
+		else
+			hi = mid;
+	}
+
+	return 0U;
+}
+
+unsigned int CDMRIdTable::size() const
+{
+	return m_idCount;
+}
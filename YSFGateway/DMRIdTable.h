@@ -0,0 +1,85 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef	DMRIdTable_H
+#define	DMRIdTable_H
+
+#include "BinaryCache.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The DMR Ids and callsigns of one load of the lookup file. It is filled by
+// load() and never changed after that, so any number of threads may read it
+// without a lock. Both directions are sorted arrays of two 32 bit words an
+// entry, searched by halving, and every callsign is held once in a shared
+// pool. The arrays are written out as they are, either as a cache of the
+// text file or by save() as a database that is used in place of it, and
+// either is mapped back rather than read.
+class CDMRIdTable {
+public:
+	CDMRIdTable();
+	~CDMRIdTable();
+
+	// The file may be a text file or a database, the cache file may be empty
+	// for none
+	bool load(const std::string& filename, const std::string& cacheFile);
+
+	// Writes a database for load()
+	bool save(const std::string& filename) const;
+
+	// NULL when the Id is not there
+	const char* findCS(unsigned int id) const;
+
+	// Zero when the callsign is not there
+	unsigned int findID(const char* cs) const;
+
+	unsigned int size() const;
+
+private:
+	struct CIdEntry {
+		uint32_t m_id;
+		uint32_t m_name;
+	};
+
+	struct CNameEntry {
+		uint32_t m_name;
+		uint32_t m_id;
+	};
+
+	std::vector<char>       m_names;
+	std::vector<CIdEntry>   m_ids;
+	std::vector<CNameEntry> m_cs;
+	CBinaryCache            m_cache;
+	const char*             m_namePtr;
+	const CIdEntry*         m_idPtr;
+	const CNameEntry*       m_csPtr;
+	unsigned int            m_idCount;
+	unsigned int            m_csCount;
+	unsigned int            m_poolSize;
+
+	bool read(const std::string& filename);
+	bool attach(const std::string& file, uint32_t kind, const std::string& source);
+	bool write(CCacheHeader& header, const std::string& file) const;
+
+	CDMRIdTable(const CDMRIdTable&);
+	CDMRIdTable& operator=(const CDMRIdTable&);
+};
+
+#endif
@@ -1,5 +1,5 @@
 /*
-*   Copyright (C) 2016,2017 by Jonathan Naylor G4KLX
+*   Copyright (C) 2016,2017,2018 by Jonathan Naylor G4KLX
 *   Copyright (C) 2018 by Andy Uribe CA6JAU
 *
 *   This program is free software; you can redistribute it and/or modify
@@ -29,16 +29,23 @@
 CDMRLookup::CDMRLookup(const std::string& filename, unsigned int reloadTime) :
 CThread(),
 m_filename(filename),
+m_cacheFile(),
 m_reloadTime(reloadTime),
-m_table(),
-m_cstable(),
-m_mutex(),
+m_table(new CDMRIdTable),
+m_retired(NULL),
 m_stop(false)
 {
 }
 
 CDMRLookup::~CDMRLookup()
 {
+	delete m_table.load();
+	delete m_retired;
+}
+
+void CDMRLookup::setCachePath(const std::string& path)
+{
+	m_cacheFile = path.empty() ? std::string() : CBinaryCache::fileName(path, m_filename, "cache");
 }
 
 bool CDMRLookup::read()
@@ -85,95 +92,45 @@ void CDMRLookup::stop()
 
 std::string CDMRLookup::findCS(unsigned int id)
 {
-	std::string callsign;
-
 	if (id == 0xFFFFFFU)
 		return std::string("ALL");
 
-	m_mutex.lock();
+	const char* callsign = m_table.load(std::memory_order_acquire)->findCS(id);
+	if (callsign != NULL)
+		return std::string(callsign);
 
-	try {
-		callsign = m_table.at(id);
-	} catch (...) {
-		char text[10U];
-		::sprintf(text, "%u", id);
-		callsign = std::string(text);
-	}
-
-	m_mutex.unlock();
+	char text[10U];
+	::sprintf(text, "%u", id);
 
-	return callsign;
+	return std::string(text);
 }
 
 unsigned int CDMRLookup::findID(std::string cs)
 {
-	unsigned int dmrID;
-
-	m_mutex.lock();
-
-	try {
-		dmrID = m_cstable.at(cs);
-	} catch (...) {
-		dmrID = 0U;
-	}
-
-	m_mutex.unlock();
-
-	return dmrID;
+	return m_table.load(std::memory_order_acquire)->findID(cs.c_str());
 }
 
 bool CDMRLookup::exists(unsigned int id)
 {
-	m_mutex.lock();
-
-	bool found = m_table.count(id) == 1U;
-
-	m_mutex.unlock();
-
-	return found;
+	return m_table.load(std::memory_order_acquire)->findCS(id) != NULL;
 }
 
 bool CDMRLookup::load()
 {
-	FILE* fp = ::fopen(m_filename.c_str(), "rt");
-	if (fp == NULL) {
-		LogWarning("Cannot open the Id lookup file - %s", m_filename.c_str());
-		return false;
-	}
-
-	m_mutex.lock();
-
-	// Remove the old entries
-	m_table.clear();
-	m_cstable.clear();
-
-	char buffer[100U];
-	while (::fgets(buffer, 100U, fp) != NULL) {
-		if (buffer[0U] == '#')
-			continue;
-
-		char* p1 = ::strtok(buffer, " \t\r\n");
-		char* p2 = ::strtok(NULL, " \t\r\n");
+	CDMRIdTable* table = new CDMRIdTable;
 
-		if (p1 != NULL && p2 != NULL) {
-			unsigned int id = (unsigned int)::atoi(p1);
-			for (char* p = p2; *p != 0x00U; p++)
-				*p = ::toupper(*p);
-
-			m_table[id] = std::string(p2);
-			m_cstable[p2] = id;
-		}
+	// Keep the current table rather than replace it with an empty one
+	if (!table->load(m_filename, m_cacheFile)) {
+		delete table;
+		return false;
 	}
 
-	m_mutex.unlock();
+	CDMRIdTable* old = m_table.exchange(table, std::memory_order_acq_rel);
 
-	::fclose(fp);
+	delete m_retired;
+	m_retired = old;
 
-	size_t size = m_table.size();
-	if (size == 0U)
-		return false;
-
-	LogInfo("Loaded %u Ids to the callsign lookup table", size);
+	LogInfo("Loaded %u Ids to the callsign lookup table", table->size());
 
 	return true;
-}
\ No newline at end of file
+}
@@ -20,17 +20,24 @@
 #ifndef	DMRLookup_H
 #define	DMRLookup_H
 
+#include "DMRIdTable.h"
 #include "Thread.h"
-#include "Mutex.h"
 
+#include <atomic>
 #include <string>
-#include <unordered_map>
 
+// The lookups read whichever table was last published, without a lock. A
+// reload builds a new table in the reload thread and swaps it in, and the
+// table it replaces is kept until the reload after, hours later, by which
+// time no lookup can still be using it.
 class CDMRLookup : public CThread {
 public:
 	CDMRLookup(const std::string& filename, unsigned int reloadTime);
 	virtual ~CDMRLookup();
 
+	// A directory for the binary copy of the file, to be set before read()
+	void setCachePath(const std::string& path);
+
 	bool read();
 
 	virtual void entry();
@@ -43,12 +50,12 @@ public:
 	void stop();
 
 private:
-	std::string                                   m_filename;
-	unsigned int                                  m_reloadTime;
-	std::unordered_map<unsigned int, std::string> m_table;
-	std::unordered_map<std::string, unsigned int> m_cstable;
-	CMutex                                        m_mutex;
-	bool                                          m_stop;
+	std::string               m_filename;
+	std::string               m_cacheFile;
+	unsigned int              m_reloadTime;
+	std::atomic<CDMRIdTable*> m_table;
+	CDMRIdTable*              m_retired;
+	bool                      m_stop;
 
 	bool load();
 };
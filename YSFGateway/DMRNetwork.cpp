@@ -28,6 +28,10 @@
 #include <cstring>
 
 const unsigned int BUFFER_LENGTH = 500U;
+const unsigned int BUFFER_SLOTS  = 16U;
+
+// The most datagrams taken off the socket in one clock()
+const unsigned int RECEIVE_BUDGET = 64U;
 
 const unsigned int HOMEBREW_DATA_PACKET_LENGTH = 55U;
 
@@ -40,6 +44,8 @@ m_duplex(duplex),
 m_version(version),
 m_debug(debug),
 m_socket(local),
+m_ring(BUFFER_SLOTS, BUFFER_LENGTH),
+m_budgetHits(0U),
 m_enabled(false),
 m_slot1(slot1),
 m_slot2(slot2),
@@ -312,10 +318,18 @@ bool CDMRNetwork::writeTalkerAlias(unsigned int id, unsigned char type, const un
 	return write(buffer, 19U);
 }
 
+unsigned int CDMRNetwork::getBudgetHits() const
+{
+	return m_budgetHits;
+}
+
 void CDMRNetwork::close()
 {
 	LogMessage("DMR, Closing DMR Network");
 
+	if (m_budgetHits > 0U)
+		LogMessage("DMR, The network receive budget was used up %u times", m_budgetHits);
+
 	if (m_status == RUNNING) {
 		unsigned char buffer[9U];
 		::memcpy(buffer + 0U, "RPTCL", 5U);
@@ -353,27 +367,100 @@ void CDMRNetwork::clock(unsigned int ms)
 		return;
 	}
 
-	in_addr address;
-	unsigned int port;
-	int length = m_socket.read(m_buffer, BUFFER_LENGTH, address, port);
-	if (length < 0) {
-		LogError("DMR, Socket has failed, retrying connection to the master");
+	// Everything queued is taken, a ring at a time and up to the budget, and
+	// handled before the slots are reused
+	unsigned int count = 0U;
+	bool reset = false;
+	do {
+		m_ring.clear();
+
+		int ret = m_socket.read(m_ring);
+		if (ret < 0) {
+			LogError("DMR, Socket has failed, retrying connection to the master");
+			close();
+			open();
+			return;
+		}
+
+		// After a reset the rest is from the old connection, but the timers
+		// below still need their time
+		for (unsigned int i = 0U; i < m_ring.size() && !reset; i++)
+			reset = !process(m_ring.at(i));
+
+		count += m_ring.size();
+	} while (!reset && m_ring.isFull() && count < RECEIVE_BUDGET);
+
+	// The loop stopped on the budget, there may well be more still queued
+	if (!reset && m_ring.isFull() && count >= RECEIVE_BUDGET)
+		m_budgetHits++;
+
+	m_retryTimer.clock(ms);
+	if (m_retryTimer.isRunning() && m_retryTimer.hasExpired()) {
+		switch (m_status) {
+			case WAITING_LOGIN:
+				writeLogin();
+				break;
+			case WAITING_AUTHORISATION:
+				writeAuthorisation();
+				break;
+			case WAITING_OPTIONS:
+				writeOptions();
+				break;
+			case WAITING_CONFIG:
+				writeConfig();
+				break;
+			case RUNNING:
+				writePing();
+				break;
+			default:
+				break;
+		}
+
+		m_retryTimer.start();
+	}
+
+	m_timeoutTimer.clock(ms);
+	if (m_timeoutTimer.isRunning() && m_timeoutTimer.hasExpired()) {
+		LogError("DMR, Connection to the master has timed out, retrying connection");
 		close();
 		open();
-		return;
 	}
+}
+
+void CDMRNetwork::reset(unsigned int slotNo)
+{
+	assert(slotNo == 1U || slotNo == 2U);
+
+	if (slotNo == 1U) {
+		m_delayBuffers[1U]->reset();
+		m_streamId[0U] = ::rand() + 1U;
+	} else {
+		m_delayBuffers[2U]->reset();
+		m_streamId[1U] = ::rand() + 1U;
+	}
+}
+
+bool CDMRNetwork::isConnected() const
+{
+	return m_status == RUNNING;
+}
 
-	 if (m_debug && length > 0)
-		CUtils::dump(1U, "Network Received", m_buffer, length);
+bool CDMRNetwork::process(const CUDPDatagram& datagram)
+{
+	const unsigned char* buffer = datagram.m_data;
+	unsigned int length = datagram.m_length;
+
+	if (m_debug)
+		CUtils::dump(1U, "Network Received", buffer, length);
 
-	if (length > 0 && m_address.s_addr == address.s_addr && m_port == port) {
-		if (::memcmp(m_buffer, "DMRD", 4U) == 0) {
+	if (m_address.s_addr == datagram.m_address.s_addr && m_port == datagram.m_port) {
+		if (::memcmp(buffer, "DMRD", 4U) == 0) {
 			if (m_enabled) {
 				if (m_debug)
-					CUtils::dump(1U, "Network Received", m_buffer, length);
-				receiveData(m_buffer, length);
+					CUtils::dump(1U, "Network Received", buffer, length);
+				receiveData(buffer, length);
 			}
-		} else if (::memcmp(m_buffer, "MSTNAK",  6U) == 0) {
+		} else if (::memcmp(buffer, "MSTNAK",  6U) == 0) {
 			if (m_status == RUNNING) {
 				LogWarning("DMR, Login to the master has failed, retrying login ...");
 				m_status = WAITING_LOGIN;
@@ -386,13 +473,13 @@ void CDMRNetwork::clock(unsigned int ms)
 				LogError("DMR, Login to the master has failed, retrying network ...");
 				close();
 				open();
-				return;
+				return false;
 			}
-		} else if (::memcmp(m_buffer, "RPTACK",  6U) == 0) {
+		} else if (::memcmp(buffer, "RPTACK",  6U) == 0) {
 			switch (m_status) {
 				case WAITING_LOGIN:
 					LogDebug("DMR, Sending authorisation");
-					::memcpy(m_salt, m_buffer + 6U, sizeof(uint32_t));
+					::memcpy(m_salt, buffer + 6U, sizeof(uint32_t));
 					writeAuthorisation();
 					m_status = WAITING_AUTHORISATION;
 					m_timeoutTimer.start();
@@ -426,68 +513,21 @@ void CDMRNetwork::clock(unsigned int ms)
 				default:
 					break;
 			}
-		} else if (::memcmp(m_buffer, "MSTCL",   5U) == 0) {
+		} else if (::memcmp(buffer, "MSTCL",   5U) == 0) {
 			LogError("DMR, Master is closing down");
 			close();
 			open();
-		} else if (::memcmp(m_buffer, "MSTPONG", 7U) == 0) {
+			return false;
+		} else if (::memcmp(buffer, "MSTPONG", 7U) == 0) {
 			m_timeoutTimer.start();
-		} else if (::memcmp(m_buffer, "RPTSBKN", 7U) == 0) {
+		} else if (::memcmp(buffer, "RPTSBKN", 7U) == 0) {
 			m_beacon = true;
 		} else {
-			CUtils::dump("Unknown packet from the master", m_buffer, length);
+			CUtils::dump("Unknown packet from the master", buffer, length);
 		}
 	}
 
-	m_retryTimer.clock(ms);
-	if (m_retryTimer.isRunning() && m_retryTimer.hasExpired()) {
-		switch (m_status) {
-			case WAITING_LOGIN:
-				writeLogin();
-				break;
-			case WAITING_AUTHORISATION:
-				writeAuthorisation();
-				break;
-			case WAITING_OPTIONS:
-				writeOptions();
-				break;
-			case WAITING_CONFIG:
-				writeConfig();
-				break;
-			case RUNNING:
-				writePing();
-				break;
-			default:
-				break;
-		}
-
-		m_retryTimer.start();
-	}
-
-	m_timeoutTimer.clock(ms);
-	if (m_timeoutTimer.isRunning() && m_timeoutTimer.hasExpired()) {
-		LogError("DMR, Connection to the master has timed out, retrying connection");
-		close();
-		open();
-	}
-}
-
-void CDMRNetwork::reset(unsigned int slotNo)
-{
-	assert(slotNo == 1U || slotNo == 2U);
-
-	if (slotNo == 1U) {
-		m_delayBuffers[1U]->reset();
-		m_streamId[0U] = ::rand() + 1U;
-	} else {
-		m_delayBuffers[2U]->reset();
-		m_streamId[1U] = ::rand() + 1U;
-	}
-}
-
-bool CDMRNetwork::isConnected() const
-{
-	return m_status == RUNNING;
+	return true;
 }
 
 void CDMRNetwork::receiveData(const unsigned char* data, unsigned int length)
@@ -54,6 +54,9 @@ public:
 
 	void clock(unsigned int ms);
 
+	// How often clock() found more ready than it could take
+	unsigned int getBudgetHits() const;
+
 	void reset(unsigned int slotNo);
 
 	bool isConnected() const;
@@ -69,6 +72,8 @@ private:
 	const char*     m_version;
 	bool            m_debug;
 	CUDPSocket      m_socket;
+	CUDPRing        m_ring;
+	unsigned int    m_budgetHits;
 	bool            m_enabled;
 	bool            m_slot1;
 	bool            m_slot2;
@@ -115,6 +120,7 @@ private:
 
 	bool write(const unsigned char* data, unsigned int length);
 
+	bool process(const CUDPDatagram& datagram);
 	void receiveData(const unsigned char* data, unsigned int length);
 };
 
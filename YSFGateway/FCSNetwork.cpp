@@ -28,6 +28,8 @@
 const char* FCS_VERSION = "YSFG-EA";
 
 const unsigned int BUFFER_LENGTH = 200U;
+// The most datagrams taken off the socket in one clock()
+const unsigned int RECEIVE_BUDGET = 64U;
 
 CFCSNetwork::CFCSNetwork(unsigned int port, const std::string& callsign, unsigned int rxFrequency, unsigned int txFrequency, const std::string& locator, const std::string& name, unsigned int id, bool debug) :	// KBC 2020-09-07
 m_socket(port),
@@ -40,7 +42,9 @@ m_info(NULL),
 m_info_long(NULL),
 m_reflector(),
 m_print(),
-m_buffer(1000U, "FCS Network Buffer"),
+m_ring(RECEIVE_BUDGET, BUFFER_LENGTH),
+m_next(0U),
+m_budgetHits(0U),
 m_n(0U),
 m_pingTimer(1000U, 0U, 800U),
 m_resetTimer(1000U, 1U),
@@ -180,19 +184,44 @@ void CFCSNetwork::clock(unsigned int ms)
 		m_resetTimer.stop();
 	}
 
-	unsigned char buffer[BUFFER_LENGTH];
+	// The slots that have been read are reused, and when none have been the
+	// oldest frame makes way for a new one
+	if (m_next == 0U && m_ring.isFull()) {
+		LogError("**** Overflow in FCS Network ring, frame dropped");
+		m_next = 1U;
+	}
+
+	m_ring.discard(m_next);
+	m_next = 0U;
+
+	unsigned int start = m_ring.size();
 
-	in_addr address;
-	unsigned int port;
-	int length = m_socket.read(buffer, BUFFER_LENGTH, address, port);
-	if (length <= 0)
+	// Everything that is ready is taken, up to the free slots
+	if (m_socket.read(m_ring) <= 0)
 		return;
 
+	// Taking the whole budget in one clock means there may well be more queued
+	if (m_ring.size() - start >= RECEIVE_BUDGET)
+		m_budgetHits++;
+
+	// Anything that isn't for read() is left in its slot with no length
+	for (unsigned int i = start; i < m_ring.size(); i++) {
+		CUDPDatagram& datagram = m_ring.at(i);
+		if (!process(datagram))
+			datagram.m_length = 0U;
+	}
+}
+
+bool CFCSNetwork::process(const CUDPDatagram& datagram)
+{
+	const unsigned char* buffer = datagram.m_data;
+	unsigned int length = datagram.m_length;
+
 	if (m_state == FCS_UNLINKED)
-		return;
+		return false;
 
-	if (address.s_addr != m_address.s_addr || port != FCS_PORT)
-		return;
+	if (datagram.m_address.s_addr != m_address.s_addr || datagram.m_port != FCS_PORT)
+		return false;
 
 	if (m_debug)
 		CUtils::dump(1U, "FCS Network Data Received", buffer, length);
@@ -213,59 +242,60 @@ void CFCSNetwork::clock(unsigned int ms)
 		writeOptions(m_print);
 	}
 
-	if (length == 7 || length == 10 || length == 130) {
-		unsigned char len = length;
-		m_buffer.addData(&len, 1U);
-		m_buffer.addData(buffer, len);
-	}
+	return length == 7 || length == 10 || length == 130;
 }
 
 unsigned int CFCSNetwork::read(unsigned char* data)
 {
 	assert(data != NULL);
 
-	if (m_buffer.isEmpty())
-		return 0U;
-
-	unsigned char len = 0U;
-	m_buffer.getData(&len, 1U);
-
-	// Pass pings up to the gateway to reset the lost timer.
-	if (len != 130U) {
-		m_buffer.getData(data, len);
+	while (m_next < m_ring.size()) {
+		const CUDPDatagram& datagram = m_ring.at(m_next++);
+		if (datagram.m_length == 0U)
+			continue;
 
-		::memset(data + 0U, ' ', 14U);
-		::memcpy(data + 0U, "YSFP", 4U);
-		::memcpy(data + 4U, m_print.c_str(), 8U);
+		// Pass pings up to the gateway to reset the lost timer.
+		if (datagram.m_length != 130U) {
+			::memset(data + 0U, ' ', 14U);
+			::memcpy(data + 0U, "YSFP", 4U);
+			::memcpy(data + 4U, m_print.c_str(), 8U);
 
-		return 14U;
-	}
+			return 14U;
+		}
 
-	m_resetTimer.start();
+		m_resetTimer.start();
 
-	unsigned char buffer[130U];
-	m_buffer.getData(buffer, len);
+		::memset(data + 0U, ' ', 35U);
+		::memcpy(data + 0U, "YSFD", 4U);
+		::memcpy(data + 35U, datagram.m_data, 130U);
 
-	::memset(data + 0U, ' ', 35U);
-	::memcpy(data + 0U, "YSFD", 4U);
-	::memcpy(data + 35U, buffer, 130U);
+		// Put the reflector name as the via callsign.
+		::memcpy(data + 4U, m_print.c_str(), 9U);
 
-	// Put the reflector name as the via callsign.
-	::memcpy(data + 4U, m_print.c_str(), 9U);
+		data[34U] = m_n;
+		m_n += 2U;
 
-	data[34U] = m_n;
-	m_n += 2U;
+		return 158U;
+	}
 
-	return 158U;
+	return 0U;
 }
 
 void CFCSNetwork::close()
 {
 	m_socket.close();
 
+	if (m_budgetHits > 0U)
+		LogMessage("The FCS network receive budget was used up %u times", m_budgetHits);
+
 	LogMessage("Closing FCS network connection");
 }
 
+unsigned int CFCSNetwork::getBudgetHits() const
+{
+	return m_budgetHits;
+}
+
 void CFCSNetwork::writeInfo(const std::string& reflector)
 {
 	if (m_state != FCS_LINKED)
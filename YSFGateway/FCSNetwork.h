@@ -21,7 +21,6 @@
 
 #include "YSFDefines.h"
 #include "UDPSocket.h"
-#include "RingBuffer.h"
 #include "Timer.h"
 
 #include <cstdint>
@@ -55,6 +54,9 @@ public:
 
 	void clock(unsigned int ms);
 
+	// How often clock() found more ready than it could take
+	unsigned int getBudgetHits() const;
+
 	void close();
 
 private:
@@ -68,7 +70,9 @@ private:
 	unsigned char*             m_info_long;
 	std::string                    m_reflector;
 	std::string                    m_print;
-	CRingBuffer<unsigned char>     m_buffer;
+	CUDPRing                       m_ring;
+	unsigned int                   m_next;
+	unsigned int                   m_budgetHits;
 	std::map<std::string, in_addr> m_addresses;
 	unsigned char                  m_n;
 	CTimer                         m_pingTimer;
@@ -78,6 +82,7 @@ private:
 	void writeOptions(const std::string& reflector);
 	void writeInfo(const std::string& reflector);
 	void writeInfoLong(const std::string& reflector);
+	bool process(const CUDPDatagram& datagram);
 	void writePing();
 };
 
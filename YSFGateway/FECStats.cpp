@@ -0,0 +1,55 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "FECStats.h"
+
+CFECStats::CFECStats() :
+m_bits(0ULL),
+m_errors(0ULL),
+m_uncorrectable(0ULL)
+{
+}
+
+void CFECStats::add(unsigned int bits, unsigned int errors, unsigned int uncorrectable)
+{
+	m_bits          += bits;
+	m_errors        += errors;
+	m_uncorrectable += uncorrectable;
+}
+
+void CFECStats::add(const CFECStats& stats)
+{
+	m_bits          += stats.m_bits;
+	m_errors        += stats.m_errors;
+	m_uncorrectable += stats.m_uncorrectable;
+}
+
+void CFECStats::reset()
+{
+	m_bits          = 0ULL;
+	m_errors        = 0ULL;
+	m_uncorrectable = 0ULL;
+}
+
+float CFECStats::getBER() const
+{
+	if (m_bits == 0ULL)
+		return 0.0F;
+
+	return float(m_errors) * 100.0F / float(m_bits);
+}
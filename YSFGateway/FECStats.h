@@ -0,0 +1,43 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#if !defined(FECSTATS_H)
+#define	FECSTATS_H
+
+// What the FEC decoders found in the coded bits they were given. Errors are
+// bits found to be wrong, whether the code then corrected them or, for the
+// repeated bits of a VCH, only saw that the copies disagreed. Uncorrectable
+// counts the codewords with more errors than the code can correct.
+class CFECStats {
+public:
+	CFECStats();
+
+	void add(unsigned int bits, unsigned int errors, unsigned int uncorrectable);
+	void add(const CFECStats& stats);
+
+	void reset();
+
+	// Errors as a percentage of the bits checked
+	float getBER() const;
+
+	unsigned long long m_bits;
+	unsigned long long m_errors;
+	unsigned long long m_uncorrectable;
+};
+
+#endif
@@ -0,0 +1,154 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "FrameQueue.h"
+#include "Defines.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstring>
+
+CFrameQueue::CFrameQueue(unsigned int records, const char* name) :
+m_name(name),
+m_records(NULL),
+m_mask(records - 1U),
+m_head(0U),
+m_tail(0U),
+m_peak(0U),
+m_overflows(0U)
+{
+	assert(records > 0U && (records & (records - 1U)) == 0U);
+	assert(name != NULL);
+
+	m_records = new CFrameRecord[records];
+}
+
+CFrameQueue::~CFrameQueue()
+{
+	delete[] m_records;
+}
+
+bool CFrameQueue::add(unsigned char tag, const unsigned char* data, unsigned int length)
+{
+	assert(data != NULL);
+	assert(length <= 255U);
+
+	unsigned int count = length > FRAME_RECORD_LENGTH ? (length + FRAME_RECORD_LENGTH - 1U) / FRAME_RECORD_LENGTH : 1U;
+
+	// The head and tail run freely, the difference is the number in use
+	unsigned int used = m_head - m_tail;
+	if ((used + count) > capacity()) {
+		LogError("**** Overflow in %s frame queue, %u + %u > %u", m_name, used, count, capacity());
+		m_overflows++;
+		return false;
+	}
+
+	CFrameRecord& first = m_records[m_head & m_mask];
+	first.m_tag     = tag;
+	first.m_records = count;
+	first.m_length  = length;
+
+	for (unsigned int i = 0U; i < count; i++) {
+		unsigned int n = length - i * FRAME_RECORD_LENGTH;
+		if (n > FRAME_RECORD_LENGTH)
+			n = FRAME_RECORD_LENGTH;
+
+		::memcpy(m_records[(m_head + i) & m_mask].m_data, data + i * FRAME_RECORD_LENGTH, n);
+	}
+
+	m_head += count;
+
+	if ((used + count) > m_peak)
+		m_peak = used + count;
+
+	return true;
+}
+
+unsigned char CFrameQueue::peek() const
+{
+	if (m_head == m_tail)
+		return TAG_NODATA;
+
+	return m_records[m_tail & m_mask].m_tag;
+}
+
+unsigned char CFrameQueue::get(unsigned char* data, unsigned int length)
+{
+	assert(data != NULL);
+
+	if (m_head == m_tail) {
+		LogError("**** Underflow in %s frame queue", m_name);
+		return TAG_NODATA;
+	}
+
+	const CFrameRecord& first = m_records[m_tail & m_mask];
+	unsigned char tag   = first.m_tag;
+	unsigned int  count = first.m_records;
+
+	if (length > first.m_length)
+		length = first.m_length;
+
+	for (unsigned int i = 0U; i < count && (i * FRAME_RECORD_LENGTH) < length; i++) {
+		unsigned int n = length - i * FRAME_RECORD_LENGTH;
+		if (n > FRAME_RECORD_LENGTH)
+			n = FRAME_RECORD_LENGTH;
+
+		::memcpy(data + i * FRAME_RECORD_LENGTH, m_records[(m_tail + i) & m_mask].m_data, n);
+	}
+
+	m_tail += count;
+
+	return tag;
+}
+
+void CFrameQueue::clear()
+{
+	m_head = 0U;
+	m_tail = 0U;
+}
+
+bool CFrameQueue::isEmpty() const
+{
+	return m_head == m_tail;
+}
+
+unsigned int CFrameQueue::size() const
+{
+	return m_head - m_tail;
+}
+
+unsigned int CFrameQueue::capacity() const
+{
+	return m_mask + 1U;
+}
+
+unsigned int CFrameQueue::peak() const
+{
+	return m_peak;
+}
+
+unsigned int CFrameQueue::overflows() const
+{
+	return m_overflows;
+}
+
+void CFrameQueue::resetStats()
+{
+	m_peak      = m_head - m_tail;
+	m_overflows = 0U;
+}
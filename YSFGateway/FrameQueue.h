@@ -0,0 +1,74 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#if !defined(FRAMEQUEUE_H)
+#define	FRAMEQUEUE_H
+
+const unsigned int FRAME_RECORD_LENGTH = 13U;
+
+// One AMBE frame and its tag. Frames longer than a record, the YSF bulk
+// frame and the DCH, carry on into the records after the first.
+class CFrameRecord {
+public:
+	unsigned char m_tag;
+	unsigned char m_records;
+	unsigned char m_length;
+	unsigned char m_data[FRAME_RECORD_LENGTH];
+};
+
+// A queue of tagged frames held in a fixed array of records, which must be a
+// power of two long. It keeps the most records it has held and the frames
+// it has dropped for being full, until resetStats().
+class CFrameQueue {
+public:
+	CFrameQueue(unsigned int records, const char* name);
+	~CFrameQueue();
+
+	bool add(unsigned char tag, const unsigned char* data, unsigned int length);
+
+	// The tag of the next frame, or TAG_NODATA
+	unsigned char peek() const;
+
+	// Copies up to length bytes of the next frame and returns its tag, or TAG_NODATA
+	unsigned char get(unsigned char* data, unsigned int length);
+
+	void clear();
+
+	bool isEmpty() const;
+
+	unsigned int size() const;
+	unsigned int capacity() const;
+
+	unsigned int peak() const;
+	unsigned int overflows() const;
+	void resetStats();
+
+private:
+	const char*   m_name;
+	CFrameRecord* m_records;
+	unsigned int  m_mask;
+	unsigned int  m_head;
+	unsigned int  m_tail;
+	unsigned int  m_peak;
+	unsigned int  m_overflows;
+
+	CFrameQueue(const CFrameQueue&);
+	CFrameQueue& operator=(const CFrameQueue&);
+};
+
+#endif
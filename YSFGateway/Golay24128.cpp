@@ -1,5 +1,5 @@
 /*
- *   Copyright (C) 2010,2016 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2010,2016,2018 by Jonathan Naylor G4KLX
  *   Copyright (C) 2002 by Robert H. Morelos-Zaragoza. All rights reserved.
  */
 
@@ -1039,34 +1039,87 @@ static const unsigned int DECODING_TABLE_23127[] = {
 	0x403000U, 0x080840U, 0x100044U, 0x011008U, 0x022800U, 0x004110U, 0x100040U, 0x100041U, 0x100042U, 0x440020U, 
 	0x011001U, 0x011000U, 0x080420U, 0x011002U, 0x100048U, 0x011004U, 0x204200U, 0x028080U};
 
-#define X22             0x00400000   /* vector representation of X^{22} */
-#define X11             0x00000800   /* vector representation of X^{11} */
-#define MASK12          0xfffff800   /* auxiliary vector for testing */
-#define GENPOL          0x00000c75   /* generator polinomial, g(x) */
+// The syndrome of each byte of a (23,12) codeword, least significant byte first,
+// so that a syndrome is the XOR of three lookups
+static const unsigned short SYNDROME_TABLE_23127[3U][256U] = {
+	{
+	0x000U, 0x001U, 0x002U, 0x003U, 0x004U, 0x005U, 0x006U, 0x007U, 0x008U, 0x009U, 0x00AU, 0x00BU, 0x00CU, 0x00DU, 0x00EU, 0x00FU,
+	0x010U, 0x011U, 0x012U, 0x013U, 0x014U, 0x015U, 0x016U, 0x017U, 0x018U, 0x019U, 0x01AU, 0x01BU, 0x01CU, 0x01DU, 0x01EU, 0x01FU,
+	0x020U, 0x021U, 0x022U, 0x023U, 0x024U, 0x025U, 0x026U, 0x027U, 0x028U, 0x029U, 0x02AU, 0x02BU, 0x02CU, 0x02DU, 0x02EU, 0x02FU,
+	0x030U, 0x031U, 0x032U, 0x033U, 0x034U, 0x035U, 0x036U, 0x037U, 0x038U, 0x039U, 0x03AU, 0x03BU, 0x03CU, 0x03DU, 0x03EU, 0x03FU,
+	0x040U, 0x041U, 0x042U, 0x043U, 0x044U, 0x045U, 0x046U, 0x047U, 0x048U, 0x049U, 0x04AU, 0x04BU, 0x04CU, 0x04DU, 0x04EU, 0x04FU,
+	0x050U, 0x051U, 0x052U, 0x053U, 0x054U, 0x055U, 0x056U, 0x057U, 0x058U, 0x059U, 0x05AU, 0x05BU, 0x05CU, 0x05DU, 0x05EU, 0x05FU,
+	0x060U, 0x061U, 0x062U, 0x063U, 0x064U, 0x065U, 0x066U, 0x067U, 0x068U, 0x069U, 0x06AU, 0x06BU, 0x06CU, 0x06DU, 0x06EU, 0x06FU,
+	0x070U, 0x071U, 0x072U, 0x073U, 0x074U, 0x075U, 0x076U, 0x077U, 0x078U, 0x079U, 0x07AU, 0x07BU, 0x07CU, 0x07DU, 0x07EU, 0x07FU,
+	0x080U, 0x081U, 0x082U, 0x083U, 0x084U, 0x085U, 0x086U, 0x087U, 0x088U, 0x089U, 0x08AU, 0x08BU, 0x08CU, 0x08DU, 0x08EU, 0x08FU,
+	0x090U, 0x091U, 0x092U, 0x093U, 0x094U, 0x095U, 0x096U, 0x097U, 0x098U, 0x099U, 0x09AU, 0x09BU, 0x09CU, 0x09DU, 0x09EU, 0x09FU,
+	0x0A0U, 0x0A1U, 0x0A2U, 0x0A3U, 0x0A4U, 0x0A5U, 0x0A6U, 0x0A7U, 0x0A8U, 0x0A9U, 0x0AAU, 0x0ABU, 0x0ACU, 0x0ADU, 0x0AEU, 0x0AFU,
+	0x0B0U, 0x0B1U, 0x0B2U, 0x0B3U, 0x0B4U, 0x0B5U, 0x0B6U, 0x0B7U, 0x0B8U, 0x0B9U, 0x0BAU, 0x0BBU, 0x0BCU, 0x0BDU, 0x0BEU, 0x0BFU,
+	0x0C0U, 0x0C1U, 0x0C2U, 0x0C3U, 0x0C4U, 0x0C5U, 0x0C6U, 0x0C7U, 0x0C8U, 0x0C9U, 0x0CAU, 0x0CBU, 0x0CCU, 0x0CDU, 0x0CEU, 0x0CFU,
+	0x0D0U, 0x0D1U, 0x0D2U, 0x0D3U, 0x0D4U, 0x0D5U, 0x0D6U, 0x0D7U, 0x0D8U, 0x0D9U, 0x0DAU, 0x0DBU, 0x0DCU, 0x0DDU, 0x0DEU, 0x0DFU,
+	0x0E0U, 0x0E1U, 0x0E2U, 0x0E3U, 0x0E4U, 0x0E5U, 0x0E6U, 0x0E7U, 0x0E8U, 0x0E9U, 0x0EAU, 0x0EBU, 0x0ECU, 0x0EDU, 0x0EEU, 0x0EFU,
+	0x0F0U, 0x0F1U, 0x0F2U, 0x0F3U, 0x0F4U, 0x0F5U, 0x0F6U, 0x0F7U, 0x0F8U, 0x0F9U, 0x0FAU, 0x0FBU, 0x0FCU, 0x0FDU, 0x0FEU, 0x0FFU},
+	{
+	0x000U, 0x100U, 0x200U, 0x300U, 0x400U, 0x500U, 0x600U, 0x700U, 0x475U, 0x575U, 0x675U, 0x775U, 0x075U, 0x175U, 0x275U, 0x375U,
+	0x49FU, 0x59FU, 0x69FU, 0x79FU, 0x09FU, 0x19FU, 0x29FU, 0x39FU, 0x0EAU, 0x1EAU, 0x2EAU, 0x3EAU, 0x4EAU, 0x5EAU, 0x6EAU, 0x7EAU,
+	0x54BU, 0x44BU, 0x74BU, 0x64BU, 0x14BU, 0x04BU, 0x34BU, 0x24BU, 0x13EU, 0x03EU, 0x33EU, 0x23EU, 0x53EU, 0x43EU, 0x73EU, 0x63EU,
+	0x1D4U, 0x0D4U, 0x3D4U, 0x2D4U, 0x5D4U, 0x4D4U, 0x7D4U, 0x6D4U, 0x5A1U, 0x4A1U, 0x7A1U, 0x6A1U, 0x1A1U, 0x0A1U, 0x3A1U, 0x2A1U,
+	0x6E3U, 0x7E3U, 0x4E3U, 0x5E3U, 0x2E3U, 0x3E3U, 0x0E3U, 0x1E3U, 0x296U, 0x396U, 0x096U, 0x196U, 0x696U, 0x796U, 0x496U, 0x596U,
+	0x27CU, 0x37CU, 0x07CU, 0x17CU, 0x67CU, 0x77CU, 0x47CU, 0x57CU, 0x609U, 0x709U, 0x409U, 0x509U, 0x209U, 0x309U, 0x009U, 0x109U,
+	0x3A8U, 0x2A8U, 0x1A8U, 0x0A8U, 0x7A8U, 0x6A8U, 0x5A8U, 0x4A8U, 0x7DDU, 0x6DDU, 0x5DDU, 0x4DDU, 0x3DDU, 0x2DDU, 0x1DDU, 0x0DDU,
+	0x737U, 0x637U, 0x537U, 0x437U, 0x337U, 0x237U, 0x137U, 0x037U, 0x342U, 0x242U, 0x142U, 0x042U, 0x742U, 0x642U, 0x542U, 0x442U,
+	0x1B3U, 0x0B3U, 0x3B3U, 0x2B3U, 0x5B3U, 0x4B3U, 0x7B3U, 0x6B3U, 0x5C6U, 0x4C6U, 0x7C6U, 0x6C6U, 0x1C6U, 0x0C6U, 0x3C6U, 0x2C6U,
+	0x52CU, 0x42CU, 0x72CU, 0x62CU, 0x12CU, 0x02CU, 0x32CU, 0x22CU, 0x159U, 0x059U, 0x359U, 0x259U, 0x559U, 0x459U, 0x759U, 0x659U,
+	0x4F8U, 0x5F8U, 0x6F8U, 0x7F8U, 0x0F8U, 0x1F8U, 0x2F8U, 0x3F8U, 0x08DU, 0x18DU, 0x28DU, 0x38DU, 0x48DU, 0x58DU, 0x68DU, 0x78DU,
+	0x067U, 0x167U, 0x267U, 0x367U, 0x467U, 0x567U, 0x667U, 0x767U, 0x412U, 0x512U, 0x612U, 0x712U, 0x012U, 0x112U, 0x212U, 0x312U,
+	0x750U, 0x650U, 0x550U, 0x450U, 0x350U, 0x250U, 0x150U, 0x050U, 0x325U, 0x225U, 0x125U, 0x025U, 0x725U, 0x625U, 0x525U, 0x425U,
+	0x3CFU, 0x2CFU, 0x1CFU, 0x0CFU, 0x7CFU, 0x6CFU, 0x5CFU, 0x4CFU, 0x7BAU, 0x6BAU, 0x5BAU, 0x4BAU, 0x3BAU, 0x2BAU, 0x1BAU, 0x0BAU,
+	0x21BU, 0x31BU, 0x01BU, 0x11BU, 0x61BU, 0x71BU, 0x41BU, 0x51BU, 0x66EU, 0x76EU, 0x46EU, 0x56EU, 0x26EU, 0x36EU, 0x06EU, 0x16EU,
+	0x684U, 0x784U, 0x484U, 0x584U, 0x284U, 0x384U, 0x084U, 0x184U, 0x2F1U, 0x3F1U, 0x0F1U, 0x1F1U, 0x6F1U, 0x7F1U, 0x4F1U, 0x5F1U},
+	{
+	0x000U, 0x366U, 0x6CCU, 0x5AAU, 0x1EDU, 0x28BU, 0x721U, 0x447U, 0x3DAU, 0x0BCU, 0x516U, 0x670U, 0x237U, 0x151U, 0x4FBU, 0x79DU,
+	0x7B4U, 0x4D2U, 0x178U, 0x21EU, 0x659U, 0x53FU, 0x095U, 0x3F3U, 0x46EU, 0x708U, 0x2A2U, 0x1C4U, 0x583U, 0x6E5U, 0x34FU, 0x029U,
+	0x31DU, 0x07BU, 0x5D1U, 0x6B7U, 0x2F0U, 0x196U, 0x43CU, 0x75AU, 0x0C7U, 0x3A1U, 0x60BU, 0x56DU, 0x12AU, 0x24CU, 0x7E6U, 0x480U,
+	0x4A9U, 0x7CFU, 0x265U, 0x103U, 0x544U, 0x622U, 0x388U, 0x0EEU, 0x773U, 0x415U, 0x1BFU, 0x2D9U, 0x69EU, 0x5F8U, 0x052U, 0x334U,
+	0x63AU, 0x55CU, 0x0F6U, 0x390U, 0x7D7U, 0x4B1U, 0x11BU, 0x27DU, 0x5E0U, 0x686U, 0x32CU, 0x04AU, 0x40DU, 0x76BU, 0x2C1U, 0x1A7U,
+	0x18EU, 0x2E8U, 0x742U, 0x424U, 0x063U, 0x305U, 0x6AFU, 0x5C9U, 0x254U, 0x132U, 0x498U, 0x7FEU, 0x3B9U, 0x0DFU, 0x575U, 0x613U,
+	0x527U, 0x641U, 0x3EBU, 0x08DU, 0x4CAU, 0x7ACU, 0x206U, 0x160U, 0x6FDU, 0x59BU, 0x031U, 0x357U, 0x710U, 0x476U, 0x1DCU, 0x2BAU,
+	0x293U, 0x1F5U, 0x45FU, 0x739U, 0x37EU, 0x018U, 0x5B2U, 0x6D4U, 0x149U, 0x22FU, 0x785U, 0x4E3U, 0x0A4U, 0x3C2U, 0x668U, 0x50EU,
+	0x001U, 0x367U, 0x6CDU, 0x5ABU, 0x1ECU, 0x28AU, 0x720U, 0x446U, 0x3DBU, 0x0BDU, 0x517U, 0x671U, 0x236U, 0x150U, 0x4FAU, 0x79CU,
+	0x7B5U, 0x4D3U, 0x179U, 0x21FU, 0x658U, 0x53EU, 0x094U, 0x3F2U, 0x46FU, 0x709U, 0x2A3U, 0x1C5U, 0x582U, 0x6E4U, 0x34EU, 0x028U,
+	0x31CU, 0x07AU, 0x5D0U, 0x6B6U, 0x2F1U, 0x197U, 0x43DU, 0x75BU, 0x0C6U, 0x3A0U, 0x60AU, 0x56CU, 0x12BU, 0x24DU, 0x7E7U, 0x481U,
+	0x4A8U, 0x7CEU, 0x264U, 0x102U, 0x545U, 0x623U, 0x389U, 0x0EFU, 0x772U, 0x414U, 0x1BEU, 0x2D8U, 0x69FU, 0x5F9U, 0x053U, 0x335U,
+	0x63BU, 0x55DU, 0x0F7U, 0x391U, 0x7D6U, 0x4B0U, 0x11AU, 0x27CU, 0x5E1U, 0x687U, 0x32DU, 0x04BU, 0x40CU, 0x76AU, 0x2C0U, 0x1A6U,
+	0x18FU, 0x2E9U, 0x743U, 0x425U, 0x062U, 0x304U, 0x6AEU, 0x5C8U, 0x255U, 0x133U, 0x499U, 0x7FFU, 0x3B8U, 0x0DEU, 0x574U, 0x612U,
+	0x526U, 0x640U, 0x3EAU, 0x08CU, 0x4CBU, 0x7ADU, 0x207U, 0x161U, 0x6FCU, 0x59AU, 0x030U, 0x356U, 0x711U, 0x477U, 0x1DDU, 0x2BBU,
+	0x292U, 0x1F4U, 0x45EU, 0x738U, 0x37FU, 0x019U, 0x5B3U, 0x6D5U, 0x148U, 0x22EU, 0x784U, 0x4E2U, 0x0A5U, 0x3C3U, 0x669U, 0x50FU}};
 
 static unsigned int get_syndrome_23127(unsigned int pattern)
 /*
- * Compute the syndrome corresponding to the given pattern, i.e., the
- * remainder after dividing the pattern (when considering it as the vector
- * representation of a polynomial) by the generator polynomial, GENPOL.
- * In the program this pattern has several meanings: (1) pattern = infomation
- * bits, when constructing the encoding table; (2) pattern = error pattern,
- * when constructing the decoding table; and (3) pattern = received vector, to
- * obtain its syndrome in decoding.
+ * Compute the syndrome of a received vector, the remainder after dividing it
+ * by the generator polynomial. The remainder of a sum is the sum of the
+ * remainders, so it is built from the remainders of each byte.
  */
 {
-	unsigned int aux = X22;
- 
-	if (pattern >= X11) {
-		while (pattern & MASK12) {
-			while (!(aux & pattern))
-				aux = aux >> 1;
+	return SYNDROME_TABLE_23127[0U][pattern & 0xFFU] ^ SYNDROME_TABLE_23127[1U][(pattern >> 8) & 0xFFU] ^ SYNDROME_TABLE_23127[2U][(pattern >> 16) & 0xFFU];
+}
 
-			pattern ^= (aux / X11) * GENPOL;
-		}
-	}
+static unsigned int count_bits(unsigned int v)
+{
+	v = v - ((v >> 1) & 0x55555555U);
+	v = (v & 0x33333333U) + ((v >> 2) & 0x33333333U);
+	v = (v + (v >> 4)) & 0x0F0F0F0FU;
 
-	return pattern;
+	return (v * 0x01010101U) >> 24;
+}
+
+static unsigned int get_parity(unsigned int v)
+{
+	v ^= v >> 16;
+	v ^= v >> 8;
+	v ^= v >> 4;
+
+	return (0x6996U >> (v & 0x0FU)) & 0x01U;
 }
 
 unsigned int CGolay24128::encode23127(unsigned int data)
@@ -1106,3 +1159,54 @@ unsigned int CGolay24128::decode24128(unsigned char* bytes)
 
 	return decode23127(code >> 1);
 }
+
+unsigned int CGolay24128::decode23127(unsigned int code, unsigned int& errors)
+{
+	unsigned int syndrome = ::get_syndrome_23127(code);
+	unsigned int error_pattern = DECODING_TABLE_23127[syndrome];
+
+	errors = ::count_bits(error_pattern);
+
+	code ^= error_pattern;
+
+	return code >> 11;
+}
+
+unsigned int CGolay24128::decode24128(unsigned int code, unsigned int& errors)
+{
+	unsigned int error_pattern = DECODING_TABLE_23127[::get_syndrome_23127(code >> 1)];
+
+	// Up to three errors in the (23,12) part are corrected, after which the
+	// parity bit says whether it was wrong too. Three corrected and a wrong
+	// parity bit can only be four errors, which this code cannot correct.
+	unsigned int count = ::count_bits(error_pattern);
+	unsigned int odd   = ::get_parity(code ^ (error_pattern << 1));
+	unsigned int bad   = odd & (count >> 1) & count;
+
+	errors = bad != 0U ? GOLAY24128_UNCORRECTABLE : count + odd;
+
+	return ((code >> 1) ^ error_pattern) >> 11;
+}
+
+unsigned int CGolay24128::decode24128(const unsigned char* bytes, unsigned int* data, unsigned char* errors, unsigned int n)
+{
+	assert(bytes != NULL);
+	assert(data != NULL);
+	assert(errors != NULL);
+
+	unsigned int total = 0U;
+
+	for (unsigned int i = 0U; i < n; i++) {
+		unsigned int code = (bytes[0U] << 16) | (bytes[1U] << 8) | bytes[2U];
+		bytes += 3U;
+
+		unsigned int count;
+		data[i] = decode24128(code, count);
+
+		errors[i] = (unsigned char)count;
+		if (count != GOLAY24128_UNCORRECTABLE)
+			total += count;
+	}
+
+	return total;
+}
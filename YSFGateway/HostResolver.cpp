@@ -0,0 +1,425 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "HostResolver.h"
+#include "BinaryCache.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <climits>
+
+// gethostbyname() is not safe to call from more than one thread, except on
+// Windows where it keeps its result per thread
+static bool lookup(const std::string& host, in_addr& address)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	address = CUDPSocket::lookup(host);
+
+	return address.s_addr != INADDR_NONE;
+#else
+	in_addr_t addr = ::inet_addr(host.c_str());
+	if (addr != in_addr_t(-1)) {
+		address.s_addr = addr;
+		return true;
+	}
+
+	struct addrinfo hints;
+	::memset(&hints, 0x00, sizeof(struct addrinfo));
+	hints.ai_family   = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+
+	struct addrinfo* res = NULL;
+	int err = ::getaddrinfo(host.c_str(), NULL, &hints, &res);
+	if (err != 0 || res == NULL) {
+		LogError("Cannot find address for host %s", host.c_str());
+		return false;
+	}
+
+	address = ((struct sockaddr_in*)res->ai_addr)->sin_addr;
+
+	::freeaddrinfo(res);
+
+	return true;
+#endif
+}
+
+CHostResolverWorker::CHostResolverWorker(CHostResolver* resolver) :
+CThread(),
+m_resolver(resolver)
+{
+	assert(resolver != NULL);
+}
+
+CHostResolverWorker::~CHostResolverWorker()
+{
+}
+
+void CHostResolverWorker::entry()
+{
+	while (m_resolver->work())
+		;
+}
+
+CHostResolver::CHostResolver(const std::string& cacheFile, unsigned int threads) :
+m_cacheFile(cacheFile),
+m_threads(threads),
+m_workers(),
+m_queue(),
+m_cache(),
+m_pending(),
+m_unresolved(),
+m_mutex(),
+m_fileMutex(),
+m_stopWatch(),
+m_busy(0U),
+m_resolved(0U),
+m_failed(0U),
+m_expired(0U),
+m_changed(false),
+m_stop(false)
+{
+	assert(threads > 0U);
+
+#if defined(_WIN32) || defined(_WIN64)
+	m_semaphore = ::CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+#else
+	::sem_init(&m_semaphore, 0, 0U);
+#endif
+}
+
+CHostResolver::~CHostResolver()
+{
+	for (std::vector<CHostResolverWorker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+		delete *it;
+
+#if defined(_WIN32) || defined(_WIN64)
+	::CloseHandle(m_semaphore);
+#else
+	::sem_destroy(&m_semaphore);
+#endif
+}
+
+bool CHostResolver::start()
+{
+	if (!m_cacheFile.empty())
+		readCache();
+
+	for (unsigned int i = 0U; i < m_threads; i++) {
+		CHostResolverWorker* worker = new CHostResolverWorker(this);
+		if (!worker->run()) {
+			LogError("Cannot start the host resolver threads");
+			delete worker;
+			return false;
+		}
+
+		m_workers.push_back(worker);
+	}
+
+	LogInfo("Started %u host resolver threads", m_threads);
+
+	return true;
+}
+
+bool CHostResolver::find(const std::string& host, in_addr& address)
+{
+	m_mutex.lock();
+
+	std::unordered_map<std::string, in_addr>::const_iterator it = m_cache.find(host);
+	bool found = it != m_cache.end();
+	if (found)
+		address = it->second;
+
+	m_mutex.unlock();
+
+	return found;
+}
+
+void CHostResolver::prefetch(const std::vector<std::string>& hosts, unsigned int timeout)
+{
+	unsigned long long deadline = m_stopWatch.micros() / 1000ULL + timeout * 1000ULL;
+
+	m_mutex.lock();
+
+	// The hosts of the last list are of no use now, unlike those asked for
+	std::deque<CRequest> wanted;
+	for (std::deque<CRequest>::const_iterator it = m_queue.begin(); it != m_queue.end(); ++it) {
+		if (it->m_wanted)
+			wanted.push_back(*it);
+		else
+			m_expired++;
+	}
+
+	m_queue.swap(wanted);
+
+	for (std::vector<std::string>::const_iterator it = hosts.begin(); it != hosts.end(); ++it) {
+		CRequest request;
+		request.m_host     = *it;
+		request.m_deadline = deadline;
+		request.m_wanted   = false;
+		m_queue.push_back(request);
+	}
+
+	m_mutex.unlock();
+
+	wakeup(hosts.size());
+}
+
+RESOLVE_STATUS CHostResolver::resolve(const std::string& host, in_addr& address)
+{
+	RESOLVE_STATUS status = RESOLVE_PENDING;
+	bool queued = false;
+
+	m_mutex.lock();
+
+	std::unordered_map<std::string, in_addr>::const_iterator it = m_cache.find(host);
+	if (it != m_cache.end()) {
+		address = it->second;
+		status  = RESOLVE_FOUND;
+	} else if (m_unresolved.erase(host) > 0U) {
+		status  = RESOLVE_FAILED;
+	} else if (m_pending.insert(host).second) {
+		CRequest request;
+		request.m_host     = host;
+		request.m_deadline = ~0ULL;
+		request.m_wanted   = true;
+		m_queue.push_front(request);
+		queued = true;
+	}
+
+	m_mutex.unlock();
+
+	if (queued)
+		wakeup(1U);
+
+	return status;
+}
+
+void CHostResolver::stop()
+{
+	m_mutex.lock();
+	m_stop = true;
+	m_mutex.unlock();
+
+	wakeup(m_workers.size());
+
+	for (std::vector<CHostResolverWorker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+		(*it)->wait();
+
+	save();
+
+	LogInfo("Stopped the host resolver threads");
+}
+
+bool CHostResolver::work()
+{
+	sleep();
+
+	m_mutex.lock();
+
+	if (m_stop) {
+		m_mutex.unlock();
+		return false;
+	}
+
+	// The prefetch that queued this may have been replaced by another
+	if (m_queue.empty()) {
+		m_mutex.unlock();
+		return true;
+	}
+
+	CRequest request = m_queue.front();
+	m_queue.pop_front();
+
+	if (m_stopWatch.micros() / 1000ULL > request.m_deadline) {
+		m_expired++;
+		bool changed = finished();
+		m_mutex.unlock();
+
+		if (changed)
+			save();
+
+		return true;
+	}
+
+	m_busy++;
+
+	m_mutex.unlock();
+
+	in_addr address;
+	bool found = lookup(request.m_host, address);
+
+	m_mutex.lock();
+
+	m_busy--;
+
+	if (found) {
+		add(request.m_host, address);
+		m_resolved++;
+	} else {
+		m_failed++;
+	}
+
+	if (request.m_wanted) {
+		m_pending.erase(request.m_host);
+		if (!found)
+			m_unresolved.insert(request.m_host);
+	}
+
+	bool changed = finished();
+
+	m_mutex.unlock();
+
+	if (changed)
+		save();
+
+	return true;
+}
+
+// With the lock held
+void CHostResolver::add(const std::string& host, const in_addr& address)
+{
+	std::unordered_map<std::string, in_addr>::iterator it = m_cache.find(host);
+	if (it == m_cache.end()) {
+		m_cache[host] = address;
+		m_changed = true;
+	} else if (it->second.s_addr != address.s_addr) {
+		it->second = address;
+		m_changed = true;
+	}
+}
+
+// With the lock held, reports on the batch once the last of it is done, true
+// when the cache should then be saved
+bool CHostResolver::finished()
+{
+	if (!m_queue.empty() || m_busy > 0U)
+		return false;
+
+	LogInfo("Resolved %u hosts, %u failed, %u left until they are used", m_resolved, m_failed, m_expired);
+
+	m_resolved = 0U;
+	m_failed   = 0U;
+	m_expired  = 0U;
+
+	return m_changed;
+}
+
+void CHostResolver::wakeup(unsigned int count)
+{
+	for (unsigned int i = 0U; i < count; i++) {
+#if defined(_WIN32) || defined(_WIN64)
+		::ReleaseSemaphore(m_semaphore, 1, NULL);
+#else
+		::sem_post(&m_semaphore);
+#endif
+	}
+}
+
+// Until there is a request, or the pool is stopping
+void CHostResolver::sleep()
+{
+#if defined(_WIN32) || defined(_WIN64)
+	::WaitForSingleObject(m_semaphore, INFINITE);
+#else
+	while (::sem_wait(&m_semaphore) == -1)
+		;
+#endif
+}
+
+// Without the lock, so that find() does not wait for the file. The copy is
+// taken once the file is ours, so an older one never replaces a newer.
+void CHostResolver::save()
+{
+	if (m_cacheFile.empty())
+		return;
+
+	m_fileMutex.lock();
+
+	m_mutex.lock();
+	bool changed = m_changed;
+	std::unordered_map<std::string, in_addr> cache;
+	if (changed)
+		cache = m_cache;
+	m_changed = false;
+	m_mutex.unlock();
+
+	if (changed && !writeCache(cache)) {
+		m_mutex.lock();
+		m_changed = true;
+		m_mutex.unlock();
+	}
+
+	m_fileMutex.unlock();
+}
+
+bool CHostResolver::readCache()
+{
+	FILE* fp = ::fopen(m_cacheFile.c_str(), "rt");
+	if (fp == NULL) {
+		LogWarning("Cannot open the host cache file - %s", m_cacheFile.c_str());
+		return false;
+	}
+
+	char buffer[300U];
+	while (::fgets(buffer, 300U, fp) != NULL) {
+		if (buffer[0U] == '#')
+			continue;
+
+		char* p1 = ::strtok(buffer, " \t\r\n");
+		char* p2 = ::strtok(NULL, " \t\r\n");
+
+		if (p1 != NULL && p2 != NULL) {
+			in_addr address;
+			address.s_addr = ::inet_addr(p2);
+			if (address.s_addr != INADDR_NONE)
+				m_cache[std::string(p1)] = address;
+		}
+	}
+
+	::fclose(fp);
+
+	LogInfo("Loaded %u addresses from the host cache", m_cache.size());
+
+	return true;
+}
+
+bool CHostResolver::writeCache(const std::unordered_map<std::string, in_addr>& cache)
+{
+	std::string temp;
+	FILE* fp = CBinaryCache::openTemp(m_cacheFile, temp, "wt");
+	if (fp == NULL) {
+		LogError("Cannot open the host cache file - %s", temp.c_str());
+		return false;
+	}
+
+	::fprintf(fp, "# Written by YSFGateway, the addresses last found for the reflector hosts\n");
+
+	for (std::unordered_map<std::string, in_addr>::const_iterator it = cache.begin(); it != cache.end(); ++it) {
+		const unsigned char* p = (const unsigned char*)&it->second;
+		::fprintf(fp, "%s\t%u.%u.%u.%u\n", it->first.c_str(), p[0U], p[1U], p[2U], p[3U]);
+	}
+
+	if (!CBinaryCache::replace(fp, temp, m_cacheFile)) {
+		LogError("Cannot write the host cache file - %s", m_cacheFile.c_str());
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,123 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#if !defined(HostResolver_H)
+#define	HostResolver_H
+
+#include "UDPSocket.h"
+#include "StopWatch.h"
+#include "Thread.h"
+#include "Mutex.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <semaphore.h>
+#endif
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+enum RESOLVE_STATUS {
+	RESOLVE_FOUND,
+	RESOLVE_PENDING,
+	RESOLVE_FAILED
+};
+
+class CHostResolver;
+
+class CHostResolverWorker : public CThread {
+public:
+	CHostResolverWorker(CHostResolver* resolver);
+	virtual ~CHostResolverWorker();
+
+	virtual void entry();
+
+private:
+	CHostResolver* m_resolver;
+};
+
+// Resolves host names on a pool of threads and remembers the answers, in
+// memory and in a file that is read back at the next start, so that a
+// reflector list can be loaded without waiting for DNS. The cached address
+// is used until a fresh lookup replaces it.
+class CHostResolver {
+public:
+	CHostResolver(const std::string& cacheFile, unsigned int threads);
+	~CHostResolver();
+
+	bool start();
+
+	// Never blocks, false when the host has not been resolved yet
+	bool find(const std::string& host, in_addr& address);
+
+	// Queues the hosts for the pool, any not started within timeout seconds
+	// are dropped and left to be resolved when they are used
+	void prefetch(const std::vector<std::string>& hosts, unsigned int timeout);
+
+	// Never blocks. A host that is not known is looked up on the pool ahead of
+	// any prefetch, and is RESOLVE_PENDING until that lookup is done.
+	RESOLVE_STATUS resolve(const std::string& host, in_addr& address);
+
+	void stop();
+
+	// Called by the workers
+	bool work();
+
+private:
+	struct CRequest {
+		std::string        m_host;
+		unsigned long long m_deadline;
+		bool               m_wanted;
+	};
+
+	std::string                              m_cacheFile;
+	unsigned int                             m_threads;
+	std::vector<CHostResolverWorker*>        m_workers;
+	std::deque<CRequest>                     m_queue;
+	std::unordered_map<std::string, in_addr> m_cache;
+	// The hosts asked for by resolve() that are still to be looked up, and
+	// those that failed and have not been reported to it yet
+	std::unordered_set<std::string>          m_pending;
+	std::unordered_set<std::string>          m_unresolved;
+	CMutex                                   m_mutex;
+	CMutex                                   m_fileMutex;
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE                                   m_semaphore;
+#else
+	sem_t                                    m_semaphore;
+#endif
+	CStopWatch                               m_stopWatch;
+	unsigned int                             m_busy;
+	unsigned int                             m_resolved;
+	unsigned int                             m_failed;
+	unsigned int                             m_expired;
+	bool                                     m_changed;
+	bool                                     m_stop;
+
+	void add(const std::string& host, const in_addr& address);
+	bool finished();
+	void wakeup(unsigned int count);
+	void sleep();
+	void save();
+	bool readCache();
+	bool writeCache(const std::unordered_map<std::string, in_addr>& cache);
+};
+
+#endif
@@ -17,11 +17,14 @@
  */
 
 #include "Log.h"
+#include "Thread.h"
+#include "Mutex.h"
 
 #if defined(_WIN32) || defined(_WIN64)
 #include <Windows.h>
 #else
 #include <sys/time.h>
+#include <semaphore.h>
 #endif
 
 #include <cstdio>
@@ -30,6 +33,15 @@
 #include <ctime>
 #include <cassert>
 #include <cstring>
+#include <climits>
+#include <atomic>
+
+// The ring must be a power of two in size
+const unsigned int LOG_RECORDS = 1024U;
+const unsigned int LOG_LENGTH  = 300U;
+
+// Enough for a full ring and the dropped message in one write
+const unsigned int LOG_BATCH   = (LOG_RECORDS + 1U) * (LOG_LENGTH + 1U);
 
 static unsigned int m_fileLevel = 2U;
 static std::string m_filePath;
@@ -37,12 +49,67 @@ static std::string m_fileRoot;
 
 static FILE* m_fpLog = NULL;
 
+// Held by whichever thread is writing out, the writer or a caller while there
+// is no writer, and around opening and closing the file
+static CMutex m_outputMutex;
+
 static unsigned int m_displayLevel = 2U;
 
 static struct tm m_tm;
 
 static char LEVELS[] = " DMIWEF";
 
+class CLogRecord {
+public:
+	std::atomic<unsigned int> m_sequence;
+	unsigned int              m_level;
+	unsigned int              m_length;
+	char                      m_text[LOG_LENGTH + 1U];
+};
+
+// Messages are formatted on the caller's thread into a bounded lock-free
+// ring, where each slot carries a sequence number that says whether it is
+// free, being filled or ready. A single writer thread takes them off in order
+// and writes each batch with one call. A full ring drops the message rather
+// than hold up the caller, and the writer reports how many went.
+class CLogWriter : public CThread {
+public:
+	CLogWriter();
+	virtual ~CLogWriter();
+
+	virtual void entry();
+
+	CLogRecord* claim();
+	void publish(CLogRecord* record);
+
+	void stop();
+
+private:
+	CLogRecord*               m_records;
+	std::atomic<unsigned int> m_head;
+	unsigned int              m_tail;
+	std::atomic<unsigned int> m_dropped;
+	std::atomic<bool>         m_idle;
+	std::atomic<bool>         m_stopped;
+	char*                     m_file;
+	unsigned int              m_fileLength;
+	char*                     m_display;
+	unsigned int              m_displayLength;
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE                    m_semaphore;
+#else
+	sem_t                     m_semaphore;
+#endif
+
+	bool isEmpty() const;
+	void drain();
+	void append(unsigned int level, const char* text, unsigned int length);
+	void wakeup();
+	void sleep();
+};
+
+static CLogWriter* m_writer = NULL;
+
 static bool LogOpen()
 {
 	if (m_fileLevel == 0U)
@@ -74,63 +141,325 @@ static bool LogOpen()
     return m_fpLog != NULL;
 }
 
+static unsigned int LogPrefix(char* buffer, unsigned int level)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	SYSTEMTIME st;
+	::GetSystemTime(&st);
+
+	return ::sprintf(buffer, "%c: %04u-%02u-%02u %02u:%02u:%02u.%03u ", LEVELS[level], st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
+#else
+	// The date and time are only formatted once a second
+	static thread_local time_t seconds = 0;
+	static thread_local char prefix[40U];
+
+	struct timeval now;
+	::gettimeofday(&now, NULL);
+
+	if (now.tv_sec != seconds) {
+		struct tm tm;
+		::gmtime_r(&now.tv_sec, &tm);
+		::sprintf(prefix, "%04d-%02d-%02d %02d:%02d:%02d", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+		seconds = now.tv_sec;
+	}
+
+	return ::sprintf(buffer, "%c: %s.%03lu ", LEVELS[level], prefix, now.tv_usec / 1000U);
+#endif
+}
+
+CLogWriter::CLogWriter() :
+CThread(),
+m_records(NULL),
+m_head(0U),
+m_tail(0U),
+m_dropped(0U),
+m_idle(false),
+m_stopped(false),
+m_file(NULL),
+m_fileLength(0U),
+m_display(NULL),
+m_displayLength(0U)
+{
+	m_records = new CLogRecord[LOG_RECORDS];
+	for (unsigned int i = 0U; i < LOG_RECORDS; i++)
+		m_records[i].m_sequence.store(i, std::memory_order_relaxed);
+
+	m_file    = new char[LOG_BATCH];
+	m_display = new char[LOG_BATCH];
+
+#if defined(_WIN32) || defined(_WIN64)
+	m_semaphore = ::CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+#else
+	::sem_init(&m_semaphore, 0, 0U);
+#endif
+}
+
+CLogWriter::~CLogWriter()
+{
+#if defined(_WIN32) || defined(_WIN64)
+	::CloseHandle(m_semaphore);
+#else
+	::sem_destroy(&m_semaphore);
+#endif
+
+	delete[] m_records;
+	delete[] m_file;
+	delete[] m_display;
+}
+
+CLogRecord* CLogWriter::claim()
+{
+	unsigned int pos = m_head.load(std::memory_order_relaxed);
+
+	for (;;) {
+		CLogRecord* record = m_records + (pos & (LOG_RECORDS - 1U));
+
+		int diff = int(record->m_sequence.load(std::memory_order_acquire) - pos);
+		if (diff == 0) {
+			if (m_head.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed))
+				return record;
+		} else if (diff < 0) {
+			// The writer has not caught up with this slot yet
+			m_dropped.fetch_add(1U, std::memory_order_relaxed);
+			return NULL;
+		} else {
+			pos = m_head.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void CLogWriter::publish(CLogRecord* record)
+{
+	assert(record != NULL);
+
+	unsigned int pos = record->m_sequence.load(std::memory_order_relaxed);
+	record->m_sequence.store(pos + 1U, std::memory_order_release);
+
+	wakeup();
+}
+
+void CLogWriter::stop()
+{
+	m_stopped.store(true);
+
+#if defined(_WIN32) || defined(_WIN64)
+	::ReleaseSemaphore(m_semaphore, 1, NULL);
+#else
+	::sem_post(&m_semaphore);
+#endif
+
+	wait();
+}
+
+void CLogWriter::entry()
+{
+	for (;;) {
+		drain();
+
+		if (m_stopped.load()) {
+			// Anything published while stopping still gets written
+			drain();
+			return;
+		}
+
+		sleep();
+	}
+}
+
+bool CLogWriter::isEmpty() const
+{
+	const CLogRecord* record = m_records + (m_tail & (LOG_RECORDS - 1U));
+
+	return record->m_sequence.load(std::memory_order_acquire) != m_tail + 1U;
+}
+
+void CLogWriter::drain()
+{
+	m_fileLength    = 0U;
+	m_displayLength = 0U;
+
+	// At most one ring's worth, so the batch buffers cannot overflow
+	for (unsigned int i = 0U; i < LOG_RECORDS && !isEmpty(); i++) {
+		CLogRecord* record = m_records + (m_tail & (LOG_RECORDS - 1U));
+
+		append(record->m_level, record->m_text, record->m_length);
+
+		// Hand the slot back for the next time round the ring
+		record->m_sequence.store(m_tail + LOG_RECORDS, std::memory_order_release);
+		m_tail++;
+	}
+
+	// Not through the ring, which may well be full again
+	unsigned int dropped = m_dropped.exchange(0U, std::memory_order_relaxed);
+	if (dropped > 0U) {
+		char text[LOG_LENGTH + 1U];
+		unsigned int length = ::LogPrefix(text, 4U);
+		length += ::sprintf(text + length, "%u log messages were dropped", dropped);
+		append(4U, text, length);
+	}
+
+	if (m_fileLength == 0U && m_displayLength == 0U)
+		return;
+
+	m_outputMutex.lock();
+
+	if (m_fileLength > 0U && ::LogOpen() && m_fpLog != NULL) {
+		::fwrite(m_file, 1U, m_fileLength, m_fpLog);
+		::fflush(m_fpLog);
+	}
+
+	if (m_displayLength > 0U) {
+		::fwrite(m_display, 1U, m_displayLength, stdout);
+		::fflush(stdout);
+	}
+
+	m_outputMutex.unlock();
+}
+
+void CLogWriter::append(unsigned int level, const char* text, unsigned int length)
+{
+	if (level >= m_fileLevel && m_fileLevel != 0U) {
+		::memcpy(m_file + m_fileLength, text, length);
+		m_fileLength += length;
+		m_file[m_fileLength++] = '\n';
+	}
+
+	if (level >= m_displayLevel && m_displayLevel != 0U) {
+		::memcpy(m_display + m_displayLength, text, length);
+		m_displayLength += length;
+		m_display[m_displayLength++] = '\n';
+	}
+}
+
+void CLogWriter::wakeup()
+{
+	// Only the first message after the writer runs dry costs a system call
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (!m_idle.load(std::memory_order_relaxed) || !m_idle.exchange(false))
+		return;
+
+#if defined(_WIN32) || defined(_WIN64)
+	::ReleaseSemaphore(m_semaphore, 1, NULL);
+#else
+	::sem_post(&m_semaphore);
+#endif
+}
+
+void CLogWriter::sleep()
+{
+	m_idle.store(true);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	// Check again, a message may have arrived before the flag was seen
+	if (!isEmpty() || m_stopped.load()) {
+		m_idle.store(false);
+		return;
+	}
+
+#if defined(_WIN32) || defined(_WIN64)
+	::WaitForSingleObject(m_semaphore, INFINITE);
+#else
+	while (::sem_wait(&m_semaphore) == -1)
+		;
+#endif
+}
+
 bool LogInitialise(const std::string& filePath, const std::string& fileRoot, unsigned int fileLevel, unsigned int displayLevel)
 {
 	m_filePath     = filePath;
 	m_fileRoot     = fileRoot;
 	m_fileLevel    = fileLevel;
 	m_displayLevel = displayLevel;
-    return ::LogOpen();
+
+	m_outputMutex.lock();
+	bool ret = ::LogOpen();
+	m_outputMutex.unlock();
+
+	if (!ret)
+		return false;
+
+	m_writer = new CLogWriter;
+
+	ret = m_writer->run();
+	if (!ret) {
+		delete m_writer;
+		m_writer = NULL;
+	}
+
+	return true;
 }
 
 void LogFinalise()
 {
-    if (m_fpLog != NULL)
+	if (m_writer != NULL) {
+		m_writer->stop();
+		delete m_writer;
+		m_writer = NULL;
+	}
+
+	m_outputMutex.lock();
+
+    if (m_fpLog != NULL) {
         ::fclose(m_fpLog);
+        m_fpLog = NULL;
+    }
+
+	m_outputMutex.unlock();
 }
 
 void Log(unsigned int level, const char* fmt, ...)
 {
     assert(fmt != NULL);
 
-	char buffer[300U];
-#if defined(_WIN32) || defined(_WIN64)
-	SYSTEMTIME st;
-	::GetSystemTime(&st);
+	CLogRecord* record = NULL;
+	char local[LOG_LENGTH + 1U];
+	char* buffer = local;
 
-	::sprintf(buffer, "%c: %04u-%02u-%02u %02u:%02u:%02u.%03u ", LEVELS[level], st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
-#else
-	struct timeval now;
-	::gettimeofday(&now, NULL);
+	if (m_writer != NULL) {
+		record = m_writer->claim();
+		if (record == NULL)
+			return;
 
-	struct tm* tm = ::gmtime(&now.tv_sec);
+		buffer = record->m_text;
+	}
 
-	::sprintf(buffer, "%c: %04d-%02d-%02d %02d:%02d:%02d.%03lu ", LEVELS[level], tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec, now.tv_usec / 1000U);
-#endif
+	unsigned int length = ::LogPrefix(buffer, level);
 
 	va_list vl;
 	va_start(vl, fmt);
 
-	::vsprintf(buffer + ::strlen(buffer), fmt, vl);
+	int ret = ::vsnprintf(buffer + length, LOG_LENGTH + 1U - length, fmt, vl);
 
 	va_end(vl);
 
-	if (level >= m_fileLevel && m_fileLevel != 0U) {
-		bool ret = ::LogOpen();
-		if (!ret)
-			return;
+	if (ret > 0)
+		length += ret;
+	if (length > LOG_LENGTH)
+		length = LOG_LENGTH;
 
-		::fprintf(m_fpLog, "%s\n", buffer);
-		::fflush(m_fpLog);
-	}
+	if (record != NULL) {
+		record->m_level  = level;
+		record->m_length = length;
+		m_writer->publish(record);
+	} else {
+		// Before the writer is started and after it is stopped
+		m_outputMutex.lock();
 
-	if (level >= m_displayLevel && m_displayLevel != 0U) {
-		::fprintf(stdout, "%s\n", buffer);
-		::fflush(stdout);
+		if (level >= m_fileLevel && m_fileLevel != 0U && ::LogOpen() && m_fpLog != NULL) {
+			::fprintf(m_fpLog, "%s\n", buffer);
+			::fflush(m_fpLog);
+		}
+
+		if (level >= m_displayLevel && m_displayLevel != 0U) {
+			::fprintf(stdout, "%s\n", buffer);
+			::fflush(stdout);
+		}
+
+		m_outputMutex.unlock();
 	}
 
 	if (level == 6U) {		// Fatal
-        ::fclose(m_fpLog);
-        exit(1);
-    }
+		::LogFinalise();
+		exit(1);
+	}
 }
@@ -0,0 +1,114 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "Metrics.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstdio>
+
+const char* SOURCE_NAMES[FEC_SOURCES] = {"dmr_ambe", "ysf_fich", "ysf_vch"};
+const char* NETWORK_NAMES[RECEIVE_NETWORKS] = {"modem", "ysf", "fcs", "dmr"};
+
+CMetrics::CMetrics()
+{
+	for (unsigned int i = 0U; i < FEC_SOURCES; i++)
+		m_transmissions[i] = 0ULL;
+
+	for (unsigned int i = 0U; i < RECEIVE_NETWORKS; i++)
+		m_budgetHits[i] = 0U;
+}
+
+CMetrics::~CMetrics()
+{
+}
+
+void CMetrics::add(FEC_SOURCE source, const CFECStats& stats)
+{
+	assert(source < FEC_SOURCES);
+
+	m_totals[source].add(stats);
+	m_last[source] = stats;
+	m_transmissions[source]++;
+}
+
+void CMetrics::setBudgetHits(RECEIVE_NETWORK network, unsigned int hits)
+{
+	assert(network < RECEIVE_NETWORKS);
+
+	m_budgetHits[network] = hits;
+}
+
+static void writeCounter(FILE* fp, const char* name, const char* help, const CFECStats* stats, unsigned long long CFECStats::* counter)
+{
+	::fprintf(fp, "# HELP ysfgateway_fec_%s %s\n", name, help);
+	::fprintf(fp, "# TYPE ysfgateway_fec_%s counter\n", name);
+	for (unsigned int i = 0U; i < FEC_SOURCES; i++)
+		::fprintf(fp, "ysfgateway_fec_%s{source=\"%s\"} %llu\n", name, SOURCE_NAMES[i], stats[i].*counter);
+}
+
+bool CMetrics::write(const std::string& file) const
+{
+	std::string temp = file + ".tmp";
+
+	FILE* fp = ::fopen(temp.c_str(), "wt");
+	if (fp == NULL) {
+		LogError("Cannot open the metrics file - %s", temp.c_str());
+		return false;
+	}
+
+	writeCounter(fp, "bits_total", "Coded bits checked by the FEC decoders.", m_totals, &CFECStats::m_bits);
+	writeCounter(fp, "errors_total", "Bit errors found by the FEC decoders.", m_totals, &CFECStats::m_errors);
+	writeCounter(fp, "uncorrectable_total", "Codewords with more errors than could be corrected.", m_totals, &CFECStats::m_uncorrectable);
+
+	::fprintf(fp, "# HELP ysfgateway_fec_transmissions_total Transmissions the FEC figures were taken from.\n");
+	::fprintf(fp, "# TYPE ysfgateway_fec_transmissions_total counter\n");
+	for (unsigned int i = 0U; i < FEC_SOURCES; i++)
+		::fprintf(fp, "ysfgateway_fec_transmissions_total{source=\"%s\"} %llu\n", SOURCE_NAMES[i], m_transmissions[i]);
+
+	::fprintf(fp, "# HELP ysfgateway_fec_last_ber_ratio Bit error rate of the last transmission.\n");
+	::fprintf(fp, "# TYPE ysfgateway_fec_last_ber_ratio gauge\n");
+	for (unsigned int i = 0U; i < FEC_SOURCES; i++)
+		::fprintf(fp, "ysfgateway_fec_last_ber_ratio{source=\"%s\"} %.6f\n", SOURCE_NAMES[i], m_last[i].getBER() / 100.0F);
+
+	::fprintf(fp, "# HELP ysfgateway_receive_budget_hits_total Clocks in which a network took as many datagrams as it is allowed.\n");
+	::fprintf(fp, "# TYPE ysfgateway_receive_budget_hits_total counter\n");
+	for (unsigned int i = 0U; i < RECEIVE_NETWORKS; i++)
+		::fprintf(fp, "ysfgateway_receive_budget_hits_total{network=\"%s\"} %u\n", NETWORK_NAMES[i], m_budgetHits[i]);
+
+	bool ret = ::ferror(fp) == 0;
+	ret = ::fclose(fp) == 0 && ret;
+	if (!ret) {
+		LogError("Cannot write the metrics file - %s", temp.c_str());
+		::remove(temp.c_str());
+		return false;
+	}
+
+#if defined(_WIN32) || defined(_WIN64)
+	// rename() will not replace an existing file here
+	::remove(file.c_str());
+#endif
+
+	if (::rename(temp.c_str(), file.c_str()) != 0) {
+		LogError("Cannot rename the metrics file - %s", file.c_str());
+		::remove(temp.c_str());
+		return false;
+	}
+
+	return true;
+}
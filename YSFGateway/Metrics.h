@@ -0,0 +1,67 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#if !defined(METRICS_H)
+#define	METRICS_H
+
+#include "FECStats.h"
+
+#include <string>
+
+enum FEC_SOURCE {
+	FEC_DMR_AMBE,
+	FEC_YSF_FICH,
+	FEC_YSF_VCH
+};
+
+const unsigned int FEC_SOURCES = 3U;
+
+enum RECEIVE_NETWORK {
+	RECEIVE_MODEM,
+	RECEIVE_YSF,
+	RECEIVE_FCS,
+	RECEIVE_DMR
+};
+
+const unsigned int RECEIVE_NETWORKS = 4U;
+
+// The FEC figures of every transmission since the gateway started, and of the
+// last one, for each place they are measured. Also how often each network used
+// up its receive budget in a clock.
+class CMetrics {
+public:
+	CMetrics();
+	~CMetrics();
+
+	// The figures of one whole transmission
+	void add(FEC_SOURCE source, const CFECStats& stats);
+
+	// The count kept by the network since it was opened
+	void setBudgetHits(RECEIVE_NETWORK network, unsigned int hits);
+
+	// Written to a temporary file and renamed, so a reader never sees half of it
+	bool write(const std::string& file) const;
+
+private:
+	CFECStats          m_totals[FEC_SOURCES];
+	CFECStats          m_last[FEC_SOURCES];
+	unsigned long long m_transmissions[FEC_SOURCES];
+	unsigned int       m_budgetHits[RECEIVE_NETWORKS];
+};
+
+#endif
@@ -29,13 +29,9 @@
 
 #include <cstdio>
 #include <cassert>
+#include <cstring>
 #include <math.h>
 
-const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
-
-#define WRITE_BIT(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
-#define READ_BIT(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
-
 const unsigned int PRNG_TABLE[] = {
 	0x42CC47U, 0x19D6FEU, 0x304729U, 0x6B2CD0U, 0x60BF47U, 0x39650EU, 0x7354F1U, 0xEACF60U, 0x819C9FU, 0xDE25CEU, 
 	0xD7B745U, 0x8CC8B8U, 0x8D592BU, 0xF71257U, 0xBCA084U, 0xA5B329U, 0xEE6AFAU, 0xF7D9A7U, 0xBCC21CU, 0x4712D9U, 
@@ -448,31 +444,232 @@ const unsigned int PRNG_TABLE[] = {
 	0xECDB0FU, 0xB542DAU, 0x9E5131U, 0xC7ABA5U, 0x8C38FEU, 0x97010BU, 0xDED290U, 0xA4CC7DU, 0xAD3D2EU, 0xF6B6B3U, 
 	0xF9A540U, 0x205ED9U, 0x634EB6U, 0x5A9567U, 0x11A6D8U, 0x0B3F09U};
 
-const unsigned int DMR_A_TABLE[] = {0U,  4U,  8U, 12U, 16U, 20U, 24U, 28U, 32U, 36U, 40U, 44U,
-									48U, 52U, 56U, 60U, 64U, 68U,  1U,  5U,  9U, 13U, 17U, 21U};
-const unsigned int DMR_B_TABLE[] = {25U, 29U, 33U, 37U, 41U, 45U, 49U, 53U, 57U, 61U, 65U, 69U,
-									 2U,  6U, 10U, 14U, 18U, 22U, 26U, 30U, 34U, 38U, 42U};
-const unsigned int DMR_C_TABLE[] = {46U, 50U, 54U, 58U, 62U, 66U, 70U,  3U,  7U, 11U, 15U, 19U, 23U,
-									27U, 31U, 35U, 39U, 43U, 47U, 51U, 55U, 59U, 63U, 67U, 71U};
-
-const unsigned int INTERLEAVE_TABLE_26_4[] = {
-	0U, 4U,  8U, 12U, 16U, 20U, 24U, 28U, 32U, 36U, 40U, 44U, 48U, 52U, 56U, 60U, 64U, 68U, 72U, 76U, 80U, 84U, 88U, 92U, 96U, 100U,
-	1U, 5U,  9U, 13U, 17U, 21U, 25U, 29U, 33U, 37U, 41U, 45U, 49U, 53U, 57U, 61U, 65U, 69U, 73U, 77U, 81U, 85U, 89U, 93U, 97U, 101U,
-	2U, 6U, 10U, 14U, 18U, 22U, 26U, 30U, 34U, 38U, 42U, 46U, 50U, 54U, 58U, 62U, 66U, 70U, 74U, 78U, 82U, 86U, 90U, 94U, 98U, 102U,
-	3U, 7U, 11U, 15U, 19U, 23U, 27U, 31U, 35U, 39U, 43U, 47U, 51U, 55U, 59U, 63U, 67U, 71U, 75U, 79U, 83U, 87U, 91U, 95U, 99U, 103U};
-
-const unsigned char WHITENING_DATA[] = {0x93U, 0xD7U, 0x51U, 0x21U, 0x9CU, 0x2FU, 0x6CU, 0xD0U, 0xEFU, 0x0FU,
-										0xF8U, 0x3DU, 0xF1U, 0x73U, 0x20U, 0x94U, 0xEDU, 0x1EU, 0x7CU, 0xD8U};
+// The AMBE frames are interleaved four ways: bit n of a frame is bit n / 4 of
+// row n % 4. The 72 bit DMR and YSF V/D mode 1 frame has rows of 18 bits
+// holding a (24 bits), b (23 bits) and c (25 bits) in turn, and the 104 bit
+// YSF V/D mode 2 VCH has rows of 26 bits. Each byte of a frame holds two bits
+// of every row, so these tables convert a byte at a time between a frame and
+// its rows, with the two bit pairs packed row 0 first.
+const unsigned char DEINTERLEAVE_TABLE_4[] = {
+	0x00U, 0x01U, 0x04U, 0x05U, 0x10U, 0x11U, 0x14U, 0x15U, 0x40U, 0x41U, 0x44U, 0x45U, 0x50U, 0x51U, 0x54U, 0x55U,
+	0x02U, 0x03U, 0x06U, 0x07U, 0x12U, 0x13U, 0x16U, 0x17U, 0x42U, 0x43U, 0x46U, 0x47U, 0x52U, 0x53U, 0x56U, 0x57U,
+	0x08U, 0x09U, 0x0CU, 0x0DU, 0x18U, 0x19U, 0x1CU, 0x1DU, 0x48U, 0x49U, 0x4CU, 0x4DU, 0x58U, 0x59U, 0x5CU, 0x5DU,
+	0x0AU, 0x0BU, 0x0EU, 0x0FU, 0x1AU, 0x1BU, 0x1EU, 0x1FU, 0x4AU, 0x4BU, 0x4EU, 0x4FU, 0x5AU, 0x5BU, 0x5EU, 0x5FU,
+	0x20U, 0x21U, 0x24U, 0x25U, 0x30U, 0x31U, 0x34U, 0x35U, 0x60U, 0x61U, 0x64U, 0x65U, 0x70U, 0x71U, 0x74U, 0x75U,
+	0x22U, 0x23U, 0x26U, 0x27U, 0x32U, 0x33U, 0x36U, 0x37U, 0x62U, 0x63U, 0x66U, 0x67U, 0x72U, 0x73U, 0x76U, 0x77U,
+	0x28U, 0x29U, 0x2CU, 0x2DU, 0x38U, 0x39U, 0x3CU, 0x3DU, 0x68U, 0x69U, 0x6CU, 0x6DU, 0x78U, 0x79U, 0x7CU, 0x7DU,
+	0x2AU, 0x2BU, 0x2EU, 0x2FU, 0x3AU, 0x3BU, 0x3EU, 0x3FU, 0x6AU, 0x6BU, 0x6EU, 0x6FU, 0x7AU, 0x7BU, 0x7EU, 0x7FU,
+	0x80U, 0x81U, 0x84U, 0x85U, 0x90U, 0x91U, 0x94U, 0x95U, 0xC0U, 0xC1U, 0xC4U, 0xC5U, 0xD0U, 0xD1U, 0xD4U, 0xD5U,
+	0x82U, 0x83U, 0x86U, 0x87U, 0x92U, 0x93U, 0x96U, 0x97U, 0xC2U, 0xC3U, 0xC6U, 0xC7U, 0xD2U, 0xD3U, 0xD6U, 0xD7U,
+	0x88U, 0x89U, 0x8CU, 0x8DU, 0x98U, 0x99U, 0x9CU, 0x9DU, 0xC8U, 0xC9U, 0xCCU, 0xCDU, 0xD8U, 0xD9U, 0xDCU, 0xDDU,
+	0x8AU, 0x8BU, 0x8EU, 0x8FU, 0x9AU, 0x9BU, 0x9EU, 0x9FU, 0xCAU, 0xCBU, 0xCEU, 0xCFU, 0xDAU, 0xDBU, 0xDEU, 0xDFU,
+	0xA0U, 0xA1U, 0xA4U, 0xA5U, 0xB0U, 0xB1U, 0xB4U, 0xB5U, 0xE0U, 0xE1U, 0xE4U, 0xE5U, 0xF0U, 0xF1U, 0xF4U, 0xF5U,
+	0xA2U, 0xA3U, 0xA6U, 0xA7U, 0xB2U, 0xB3U, 0xB6U, 0xB7U, 0xE2U, 0xE3U, 0xE6U, 0xE7U, 0xF2U, 0xF3U, 0xF6U, 0xF7U,
+	0xA8U, 0xA9U, 0xACU, 0xADU, 0xB8U, 0xB9U, 0xBCU, 0xBDU, 0xE8U, 0xE9U, 0xECU, 0xEDU, 0xF8U, 0xF9U, 0xFCU, 0xFDU,
+	0xAAU, 0xABU, 0xAEU, 0xAFU, 0xBAU, 0xBBU, 0xBEU, 0xBFU, 0xEAU, 0xEBU, 0xEEU, 0xEFU, 0xFAU, 0xFBU, 0xFEU, 0xFFU};
+
+const unsigned char INTERLEAVE_TABLE_4[] = {
+	0x00U, 0x01U, 0x10U, 0x11U, 0x02U, 0x03U, 0x12U, 0x13U, 0x20U, 0x21U, 0x30U, 0x31U, 0x22U, 0x23U, 0x32U, 0x33U,
+	0x04U, 0x05U, 0x14U, 0x15U, 0x06U, 0x07U, 0x16U, 0x17U, 0x24U, 0x25U, 0x34U, 0x35U, 0x26U, 0x27U, 0x36U, 0x37U,
+	0x40U, 0x41U, 0x50U, 0x51U, 0x42U, 0x43U, 0x52U, 0x53U, 0x60U, 0x61U, 0x70U, 0x71U, 0x62U, 0x63U, 0x72U, 0x73U,
+	0x44U, 0x45U, 0x54U, 0x55U, 0x46U, 0x47U, 0x56U, 0x57U, 0x64U, 0x65U, 0x74U, 0x75U, 0x66U, 0x67U, 0x76U, 0x77U,
+	0x08U, 0x09U, 0x18U, 0x19U, 0x0AU, 0x0BU, 0x1AU, 0x1BU, 0x28U, 0x29U, 0x38U, 0x39U, 0x2AU, 0x2BU, 0x3AU, 0x3BU,
+	0x0CU, 0x0DU, 0x1CU, 0x1DU, 0x0EU, 0x0FU, 0x1EU, 0x1FU, 0x2CU, 0x2DU, 0x3CU, 0x3DU, 0x2EU, 0x2FU, 0x3EU, 0x3FU,
+	0x48U, 0x49U, 0x58U, 0x59U, 0x4AU, 0x4BU, 0x5AU, 0x5BU, 0x68U, 0x69U, 0x78U, 0x79U, 0x6AU, 0x6BU, 0x7AU, 0x7BU,
+	0x4CU, 0x4DU, 0x5CU, 0x5DU, 0x4EU, 0x4FU, 0x5EU, 0x5FU, 0x6CU, 0x6DU, 0x7CU, 0x7DU, 0x6EU, 0x6FU, 0x7EU, 0x7FU,
+	0x80U, 0x81U, 0x90U, 0x91U, 0x82U, 0x83U, 0x92U, 0x93U, 0xA0U, 0xA1U, 0xB0U, 0xB1U, 0xA2U, 0xA3U, 0xB2U, 0xB3U,
+	0x84U, 0x85U, 0x94U, 0x95U, 0x86U, 0x87U, 0x96U, 0x97U, 0xA4U, 0xA5U, 0xB4U, 0xB5U, 0xA6U, 0xA7U, 0xB6U, 0xB7U,
+	0xC0U, 0xC1U, 0xD0U, 0xD1U, 0xC2U, 0xC3U, 0xD2U, 0xD3U, 0xE0U, 0xE1U, 0xF0U, 0xF1U, 0xE2U, 0xE3U, 0xF2U, 0xF3U,
+	0xC4U, 0xC5U, 0xD4U, 0xD5U, 0xC6U, 0xC7U, 0xD6U, 0xD7U, 0xE4U, 0xE5U, 0xF4U, 0xF5U, 0xE6U, 0xE7U, 0xF6U, 0xF7U,
+	0x88U, 0x89U, 0x98U, 0x99U, 0x8AU, 0x8BU, 0x9AU, 0x9BU, 0xA8U, 0xA9U, 0xB8U, 0xB9U, 0xAAU, 0xABU, 0xBAU, 0xBBU,
+	0x8CU, 0x8DU, 0x9CU, 0x9DU, 0x8EU, 0x8FU, 0x9EU, 0x9FU, 0xACU, 0xADU, 0xBCU, 0xBDU, 0xAEU, 0xAFU, 0xBEU, 0xBFU,
+	0xC8U, 0xC9U, 0xD8U, 0xD9U, 0xCAU, 0xCBU, 0xDAU, 0xDBU, 0xE8U, 0xE9U, 0xF8U, 0xF9U, 0xEAU, 0xEBU, 0xFAU, 0xFBU,
+	0xCCU, 0xCDU, 0xDCU, 0xDDU, 0xCEU, 0xCFU, 0xDEU, 0xDFU, 0xECU, 0xEDU, 0xFCU, 0xFDU, 0xEEU, 0xEFU, 0xFEU, 0xFFU};
+
+// The YSF V/D mode 2 VCH sends a and b, and the top three bits of c, three
+// times over. These spread a nibble to twelve bits and take the middle bit of
+// each of three triples.
+const unsigned int TRIPLE_TABLE[] = {
+	0x000U, 0x007U, 0x038U, 0x03FU, 0x1C0U, 0x1C7U, 0x1F8U, 0x1FFU,
+	0xE00U, 0xE07U, 0xE38U, 0xE3FU, 0xFC0U, 0xFC7U, 0xFF8U, 0xFFFU};
+
+const unsigned char MIDDLE_TABLE[] = {
+	0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U,
+	0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U,
+	0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U,
+	0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U,
+	0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U,
+	0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U,
+	0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U,
+	0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U,
+	0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U,
+	0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U,
+	0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U,
+	0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x0U, 0x0U, 0x1U, 0x1U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U, 0x2U, 0x2U, 0x3U, 0x3U,
+	0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U,
+	0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U,
+	0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U,
+	0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x4U, 0x4U, 0x5U, 0x5U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U, 0x6U, 0x6U, 0x7U, 0x7U};
+
+// The YSF V/D mode 2 whitening, laid out as the four rows of the VCH
+const unsigned int WHITENING_ROWS[] = {0x24F5D44U, 0x219C2F6U, 0x3343BC3U, 0x3F83DF1U};
+
+// The bits the FEC can check, the Golay coded a and b of an AMBE frame and the
+// repeated bits of a VCH
+const unsigned int AMBE_CHECKED_BITS = 47U;
+const unsigned int VCH_CHECKED_BITS  = 81U;
 
 const unsigned char DMR_SILENCE[] = {0xB9U, 0xE8U, 0x81U, 0x52U, 0x61U, 0x73U, 0x00U, 0x2AU, 0x6BU};
 const unsigned char YSF_SILENCE[] = {0x7BU, 0xB2U, 0x8EU, 0x43U, 0x36U, 0xE4U, 0xA2U, 0x39U, 0x78U, 0x49U, 0x33U, 0x68U, 0x33U};
 const unsigned char YSF_SILENCEV1[] = {0x7BU, 0xB2U, 0x8EU, 0x43U, 0x36U, 0xE4U, 0xA2U, 0x39U, 0x78U, 0x49U, 0x33U, 0x68U, 0x33U};
 
+static void deinterleave(const unsigned char* in, unsigned int length, unsigned int* rows)
+{
+	unsigned int r0 = 0U, r1 = 0U, r2 = 0U, r3 = 0U;
+
+	for (unsigned int i = 0U; i < length; i++) {
+		unsigned int v = DEINTERLEAVE_TABLE_4[in[i]];
+		r0 = (r0 << 2) | (v >> 6);
+		r1 = (r1 << 2) | ((v >> 4) & 0x03U);
+		r2 = (r2 << 2) | ((v >> 2) & 0x03U);
+		r3 = (r3 << 2) | (v & 0x03U);
+	}
+
+	rows[0U] = r0;
+	rows[1U] = r1;
+	rows[2U] = r2;
+	rows[3U] = r3;
+}
+
+static void interleave(const unsigned int* rows, unsigned int length, unsigned char* out)
+{
+	unsigned int shift = length * 2U;
+
+	for (unsigned int i = 0U; i < length; i++) {
+		shift -= 2U;
+		unsigned int v = ((rows[0U] >> shift) & 0x03U) << 6;
+		v |= ((rows[1U] >> shift) & 0x03U) << 4;
+		v |= ((rows[2U] >> shift) & 0x03U) << 2;
+		v |= (rows[3U] >> shift) & 0x03U;
+		out[i] = INTERLEAVE_TABLE_4[v];
+	}
+}
+
+void CModeConv::decodeDMR(const unsigned char* bytes, unsigned int* a, unsigned int* b, unsigned int* c)
+{
+	assert(bytes != NULL);
+	assert(a != NULL);
+	assert(b != NULL);
+	assert(c != NULL);
+
+	// The second frame is split either side of the sync
+	unsigned char frame[9U];
+	::memcpy(frame, bytes + 9U, 4U);
+	frame[4U] = (bytes[13U] & 0xF0U) | (bytes[19U] & 0x0FU);
+	::memcpy(frame + 5U, bytes + 20U, 4U);
+
+	decodeAMBE(bytes, a[0U], b[0U], c[0U]);
+	decodeAMBE(frame, a[1U], b[1U], c[1U]);
+	decodeAMBE(bytes + 24U, a[2U], b[2U], c[2U]);
+}
+
+void CModeConv::decodeAMBE(const unsigned char* in, unsigned int& a, unsigned int& b, unsigned int& c)
+{
+	unsigned int rows[4U];
+	deinterleave(in, 9U, rows);
+
+	a = (rows[0U] << 6) | (rows[1U] >> 12);
+	b = ((rows[1U] & 0xFFFU) << 11) | (rows[2U] >> 7);
+	c = ((rows[2U] & 0x7FU) << 18) | rows[3U];
+}
+
+void CModeConv::encodeAMBE(unsigned int a, unsigned int b, unsigned int c, unsigned char* out)
+{
+	unsigned int rows[4U];
+	rows[0U] = (a >> 6) & 0x3FFFFU;
+	rows[1U] = ((a & 0x3FU) << 12) | ((b >> 11) & 0xFFFU);
+	rows[2U] = ((b & 0x7FFU) << 7) | ((c >> 18) & 0x7FU);
+	rows[3U] = c & 0x3FFFFU;
+
+	interleave(rows, 9U, out);
+}
+
+static unsigned int middle(unsigned long long bits)
+{
+	return (MIDDLE_TABLE[(bits >> 27) & 0x1FFU] << 9) | (MIDDLE_TABLE[(bits >> 18) & 0x1FFU] << 6) |
+		   (MIDDLE_TABLE[(bits >> 9) & 0x1FFU] << 3) | MIDDLE_TABLE[bits & 0x1FFU];
+}
+
+static unsigned long long triple(unsigned int bits)
+{
+	return ((unsigned long long)TRIPLE_TABLE[(bits >> 8) & 0x0FU] << 24) | (TRIPLE_TABLE[(bits >> 4) & 0x0FU] << 12) | TRIPLE_TABLE[bits & 0x0FU];
+}
+
+static unsigned int countBits(unsigned long long v)
+{
+	v = v - ((v >> 1) & 0x5555555555555555ULL);
+	v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+	v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+	return (unsigned int)((v * 0x0101010101010101ULL) >> 56);
+}
+
+// The number of triples whose copies do not all agree, mask having the
+// lowest bit of each triple set
+static unsigned int disagreements(unsigned long long bits, unsigned long long mask)
+{
+	unsigned long long diff = bits ^ (bits >> 1);
+
+	return countBits((diff | (diff >> 1)) & mask);
+}
+
+// The VCH is dat_a and dat_b sent three times, the top three bits of dat_c
+// sent three times, the rest of dat_c, and a zero bit, whitened. Errors is
+// the number of repeated bits whose copies disagree.
+void CModeConv::decodeVCH(const unsigned char* in, unsigned int& dat_a, unsigned int& dat_b, unsigned int& dat_c, unsigned int& errors)
+{
+	unsigned int rows[4U];
+	deinterleave(in, 13U, rows);
+
+	for (unsigned int i = 0U; i < 4U; i++)
+		rows[i] ^= WHITENING_ROWS[i];
+
+	unsigned long long a = ((unsigned long long)rows[0U] << 10) | (rows[1U] >> 16);
+	unsigned long long b = ((unsigned long long)(rows[1U] & 0xFFFFU) << 20) | (rows[2U] >> 6);
+	unsigned int c = ((rows[2U] & 0x3FU) << 3) | (rows[3U] >> 23);
+
+	dat_a = middle(a);
+	dat_b = middle(b);
+	dat_c = (MIDDLE_TABLE[c] << 22) | ((rows[3U] >> 1) & 0x3FFFFFU);
+
+	errors = disagreements(a, 0x249249249ULL) + disagreements(b, 0x249249249ULL) + disagreements(c, 0x49ULL);
+}
+
+void CModeConv::encodeVCH(unsigned int dat_a, unsigned int dat_b, unsigned int dat_c, unsigned char* out)
+{
+	unsigned long long a = triple(dat_a);
+	unsigned long long b = triple(dat_b);
+	unsigned int c = TRIPLE_TABLE[(dat_c >> 22) & 0x07U] & 0x1FFU;
+
+	unsigned int rows[4U];
+	rows[0U] = (unsigned int)(a >> 10);
+	rows[1U] = (unsigned int)(((a & 0x3FFU) << 16) | (b >> 20));
+	rows[2U] = (unsigned int)(((b & 0xFFFFFU) << 6) | (c >> 3));
+	rows[3U] = ((c & 0x07U) << 23) | ((dat_c & 0x3FFFFFU) << 1);
+
+	for (unsigned int i = 0U; i < 4U; i++)
+		rows[i] ^= WHITENING_ROWS[i];
+
+	interleave(rows, 13U, out);
+}
+
 CModeConv::CModeConv() :
 m_ysfN(0U),
 m_dmrN(0U),
-m_YSF(50000U, "DMR2YSF"),
-m_DMR(50000U, "YSF2DMR")
+m_YSF(MODECONV_QUEUE_LENGTH, "DMR2YSF"),
+m_DMR(MODECONV_QUEUE_LENGTH, "YSF2DMR"),
+m_dmrStats(),
+m_ysfStats()
 {
 }
 
@@ -484,68 +681,32 @@ void CModeConv::putDMR(unsigned char* bytes)
 {
 	assert(bytes != NULL);
 
-	unsigned int a1 = 0U, a2 = 0U, a3 = 0U;
-	unsigned int MASK = 0x800000U;
-	for (unsigned int i = 0U; i < 24U; i++, MASK >>= 1) {
-		unsigned int a1Pos = DMR_A_TABLE[i];
-		unsigned int a2Pos = a1Pos + 72U;
-		if (a2Pos >= 108U)
-			a2Pos += 48U;
-		unsigned int a3Pos = a1Pos + 192U;
-
-		if (READ_BIT(bytes, a1Pos))
-			a1 |= MASK;
-		if (READ_BIT(bytes, a2Pos))
-			a2 |= MASK;
-		if (READ_BIT(bytes, a3Pos))
-			a3 |= MASK;
-	}
+	unsigned int a[3U], b[3U], c[3U];
+	decodeDMR(bytes, a, b, c);
 
-	unsigned int b1 = 0U, b2 = 0U, b3 = 0U;
-	MASK = 0x400000U;
-	for (unsigned int i = 0U; i < 23U; i++, MASK >>= 1) {
-		unsigned int b1Pos = DMR_B_TABLE[i];
-		unsigned int b2Pos = b1Pos + 72U;
-		if (b2Pos >= 108U)
-			b2Pos += 48U;
-		unsigned int b3Pos = b1Pos + 192U;
-
-		if (READ_BIT(bytes, b1Pos))
-			b1 |= MASK;
-		if (READ_BIT(bytes, b2Pos))
-			b2 |= MASK;
-		if (READ_BIT(bytes, b3Pos))
-			b3 |= MASK;
-	}
+	for (unsigned int i = 0U; i < 3U; i++)
+		checkAMBE(a[i], b[i]);
 
-	unsigned int c1 = 0U, c2 = 0U, c3 = 0U;
-	MASK = 0x1000000U;
-	for (unsigned int i = 0U; i < 25U; i++, MASK >>= 1) {
-		unsigned int c1Pos = DMR_C_TABLE[i];
-		unsigned int c2Pos = c1Pos + 72U;
-		if (c2Pos >= 108U)
-			c2Pos += 48U;
-		unsigned int c3Pos = c1Pos + 192U;
-
-		if (READ_BIT(bytes, c1Pos))
-			c1 |= MASK;
-		if (READ_BIT(bytes, c2Pos))
-			c2 |= MASK;
-		if (READ_BIT(bytes, c3Pos))
-			c3 |= MASK;
-	}
+	for (unsigned int i = 0U; i < 3U; i++)
+		putAMBE2YSF(a[i], b[i], c[i]);
+}
+
+// Only counts the errors, the AMBE is passed on as it came
+void CModeConv::checkAMBE(unsigned int a, unsigned int b)
+{
+	unsigned int errorsA, errorsB;
+	unsigned int dat_a = CGolay24128::decode24128(a, errorsA);
+	CGolay24128::decode23127(b ^ (PRNG_TABLE[dat_a] >> 1), errorsB);
 
-	putAMBE2YSF(a1, b1, c1);
-	putAMBE2YSF(a2, b2, c2);
-	putAMBE2YSF(a3, b3, c3);
+	if (errorsA == GOLAY24128_UNCORRECTABLE)
+		m_dmrStats.add(AMBE_CHECKED_BITS, errorsB, 1U);
+	else
+		m_dmrStats.add(AMBE_CHECKED_BITS, errorsA + errorsB, 0U);
 }
 
 void CModeConv::AMB2YSF_Mode2(unsigned char * bytes){
 
-	unsigned char vch[13U];
 	unsigned char ysfFrame[13U];
-	::memset(vch, 0U, 13U);
-	::memset(ysfFrame, 0, 13U);
 	unsigned int dat_a,dat_b,dat_c,tmp,tmp1;
 
 	dat_a=((((unsigned int)bytes[1])<<4)|(((unsigned int)bytes[2]>>4)&0x0F));
@@ -560,47 +721,9 @@ void CModeConv::AMB2YSF_Mode2(unsigned char * bytes){
 	tmp=tmp|tmp1;
     dat_c=tmp|(bytes[7]&0x01);
 
-	for (unsigned int i = 0U; i < 12U; i++) {
-		bool s = (dat_a << (20U + i)) & 0x80000000U;
-		WRITE_BIT(vch, 3*i + 0U, s);
-		WRITE_BIT(vch, 3*i + 1U, s);
-		WRITE_BIT(vch, 3*i + 2U, s);
-	}
-
-	for (unsigned int i = 0U; i < 12U; i++) {
-		bool s = (dat_b << (20U + i)) & 0x80000000U;
-		WRITE_BIT(vch, 3*(i + 12U) + 0U, s);
-		WRITE_BIT(vch, 3*(i + 12U) + 1U, s);
-		WRITE_BIT(vch, 3*(i + 12U) + 2U, s);
-	}
-
-	for (unsigned int i = 0U; i < 3U; i++) {
-		bool s = (dat_c << (7U + i)) & 0x80000000U;
-		WRITE_BIT(vch, 3*(i + 24U) + 0U, s);
-		WRITE_BIT(vch, 3*(i + 24U) + 1U, s);
-		WRITE_BIT(vch, 3*(i + 24U) + 2U, s);
-	}
-
-	for (unsigned int i = 0U; i < 22U; i++) {
-		bool s = (dat_c << (10U + i)) & 0x80000000U;
-		WRITE_BIT(vch, i + 81U, s);
-	}
+	encodeVCH(dat_a, dat_b, dat_c, ysfFrame);
 
-	WRITE_BIT(vch, 103U, 0U);
-
-	// Scramble
-	for (unsigned int i = 0U; i < 13U; i++)
-		vch[i] ^= WHITENING_DATA[i];
-
-	// Interleave
-	for (unsigned int i = 0U; i < 104U; i++) {
-		unsigned int n = INTERLEAVE_TABLE_26_4[i];
-		bool s = READ_BIT(vch, i);
-		WRITE_BIT(ysfFrame, n, s);
-	}
-
-	m_YSF.addData(&TAG_DATA, 1U);
-	m_YSF.addData(ysfFrame, 13U);
+	m_YSF.add(TAG_DATA, ysfFrame, 13U);
 	//CUtils::dump(1U, "VCH V/D type 2:", ysfFrame, 13U);
 
 	m_ysfN += 1U;
@@ -609,9 +732,6 @@ void CModeConv::AMB2YSF_Mode2(unsigned char * bytes){
 void CModeConv::AMB2YSF_Mode1(unsigned char * bytes){
 
 	unsigned char vch[9U];
-//	unsigned char ysfFrame[9U];
-	::memset(vch, 0U, 9U);
-//	::memset(ysfFrame, 0, 9U);
 	unsigned int dat_a,dat_b,dat_c,tmp,tmp1;
 	unsigned int a,b;
 
@@ -634,26 +754,9 @@ void CModeConv::AMB2YSF_Mode1(unsigned char * bytes){
 	unsigned int p = PRNG_TABLE[dat_a] >> 1;
 	b ^= p;
 
-	unsigned int MASK = 0x800000U;
-	for (unsigned int i = 0U; i < 24U; i++, MASK >>= 1) {
-		unsigned int aPos = DMR_A_TABLE[i];
-		WRITE_BIT(vch, aPos, a & MASK);
-	}
-
-	MASK = 0x400000U;
-	for (unsigned int i = 0U; i < 23U; i++, MASK >>= 1) {
-		unsigned int bPos = DMR_B_TABLE[i];
-		WRITE_BIT(vch, bPos, b & MASK);
-	}
-
-	MASK = 0x1000000U;
-	for (unsigned int i = 0U; i < 25U; i++, MASK >>= 1) {
-		unsigned int cPos = DMR_C_TABLE[i];
-		WRITE_BIT(vch, cPos, dat_c & MASK);
-	}
+	encodeAMBE(a, b, dat_c, vch);
 
-	m_YSF.addData(&TAG_DATAV1, 1U);
-	m_YSF.addData(vch, 9U);
+	m_YSF.add(TAG_DATAV1, vch, 9U);
 //	CUtils::dump(1U, "VCH V/D type 1:", vch, 9U);
 
 	m_ysfN += 1U;
@@ -661,10 +764,7 @@ void CModeConv::AMB2YSF_Mode1(unsigned char * bytes){
 
 void CModeConv::putAMBE2YSF(unsigned int a, unsigned int b, unsigned int dat_c)
 {
-	unsigned char vch[13U];
 	unsigned char ysfFrame[13U];
-	::memset(vch, 0U, 13U);
-	::memset(ysfFrame, 0, 13U);
 
 	// AMBE adjust
 
@@ -703,47 +803,9 @@ void CModeConv::putAMBE2YSF(unsigned int a, unsigned int b, unsigned int dat_c)
 
 	unsigned int dat_b = b >> 11;
 
-	for (unsigned int i = 0U; i < 12U; i++) {
-		bool s = (dat_a << (20U + i)) & 0x80000000U;
-		WRITE_BIT(vch, 3*i + 0U, s);
-		WRITE_BIT(vch, 3*i + 1U, s);
-		WRITE_BIT(vch, 3*i + 2U, s);
-	}
-	
-	for (unsigned int i = 0U; i < 12U; i++) {
-		bool s = (dat_b << (20U + i)) & 0x80000000U;
-		WRITE_BIT(vch, 3*(i + 12U) + 0U, s);
-		WRITE_BIT(vch, 3*(i + 12U) + 1U, s);
-		WRITE_BIT(vch, 3*(i + 12U) + 2U, s);
-	}
-	
-	for (unsigned int i = 0U; i < 3U; i++) {
-		bool s = (dat_c << (7U + i)) & 0x80000000U;
-		WRITE_BIT(vch, 3*(i + 24U) + 0U, s);
-		WRITE_BIT(vch, 3*(i + 24U) + 1U, s);
-		WRITE_BIT(vch, 3*(i + 24U) + 2U, s);
-	}
-
-	for (unsigned int i = 0U; i < 22U; i++) {
-		bool s = (dat_c << (10U + i)) & 0x80000000U;
-		WRITE_BIT(vch, i + 81U, s);
-	}
-	
-	WRITE_BIT(vch, 103U, 0U);
-
-	// Scramble
-	for (unsigned int i = 0U; i < 13U; i++)
-		vch[i] ^= WHITENING_DATA[i];
+	encodeVCH(dat_a, dat_b, dat_c, ysfFrame);
 
-	// Interleave
-	for (unsigned int i = 0U; i < 104U; i++) {
-		unsigned int n = INTERLEAVE_TABLE_26_4[i];
-		bool s = READ_BIT(vch, i);
-		WRITE_BIT(ysfFrame, n, s);
-	}
-
-	m_YSF.addData(&TAG_DATA, 1U);
-	m_YSF.addData(ysfFrame, 13U);
+	m_YSF.add(TAG_DATA, ysfFrame, 13U);
 	//CUtils::dump(1U, "VCH V/D type 2:", ysfFrame, 13U);
 	
 	m_ysfN += 1U;
@@ -754,36 +816,15 @@ void CModeConv::putYSF_Mode1(const unsigned char* data, FILE *file) {
 
 	data += YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
 
-	unsigned int offset = 72U; // DCH(0)
+	unsigned int offset = 9U; // DCH(0)
     unsigned char buf[40];
 	unsigned char pos=0;
 
 	// We have a total of 5 VCH sections, iterate through each
-	for (unsigned int j = 0U; j < 5U; j++, offset += 144U) {
-
-		unsigned int a = 0U;
-		unsigned int MASK = 0x800000U;
-		for (unsigned int i = 0U; i < 24U; i++, MASK >>= 1) {
-			unsigned int aPos = DMR_A_TABLE[i];
-			if (READ_BIT(data, aPos + offset))
-				a |= MASK;
-		}
-
-		unsigned int b = 0U;
-		MASK = 0x400000U;
-		for (unsigned int i = 0U; i < 23U; i++, MASK >>= 1) {
-			unsigned int bPos = DMR_B_TABLE[i];
-			if (READ_BIT(data, bPos + offset))
-				b |= MASK;
-		}
+	for (unsigned int j = 0U; j < 5U; j++, offset += 18U) {
 
-		unsigned int dat_c = 0U;
-		MASK = 0x1000000U;
-		for (unsigned int i = 0U; i < 25U; i++, MASK >>= 1) {
-			unsigned int cPos = DMR_C_TABLE[i];
-			if (READ_BIT(data, cPos + offset))
-				dat_c |= MASK;
-		}
+		unsigned int a, b, dat_c;
+		decodeAMBE(data + offset, a, b, dat_c);
 		
 		unsigned int dat_a = CGolay24128::decode24128(a);  //128
 		// The PRNG
@@ -815,52 +856,15 @@ void CModeConv::putYSF_Mode2(unsigned char* data, FILE *file) {
 
 	data += YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
 
-	unsigned int offset = 40U; // DCH(0)
+	unsigned int offset = 5U; // DCH(0)
     unsigned char buf[40];
 	unsigned char pos=0;
 
 	// We have a total of 5 VCH sections, iterate through each
-	for (unsigned int j = 0U; j < 5U; j++, offset += 144U) {
-
-		unsigned char vch[13U];
-		unsigned int dat_a = 0U;
-		unsigned int dat_b = 0U;
-		unsigned int dat_c = 0U;
-
-		// Deinterleave
-		for (unsigned int i = 0U; i < 104U; i++) {
-			unsigned int n = INTERLEAVE_TABLE_26_4[i];
-			bool s = READ_BIT(data, offset + n);
-			WRITE_BIT(vch, i, s);
-		}
-
-		// "Un-whiten" (descramble)
-		for (unsigned int i = 0U; i < 13U; i++)
-			vch[i] ^= WHITENING_DATA[i];
-	
-		for (unsigned int i = 0U; i < 12U; i++) {
-			dat_a <<= 1U;
-			if (READ_BIT(vch, 3U*i + 1U))
-				dat_a |= 0x01U;;
-		}
-		
-		for (unsigned int i = 0U; i < 12U; i++) {
-			dat_b <<= 1U;
-			if (READ_BIT(vch, 3U*(i + 12U) + 1U))
-				dat_b |= 0x01U;;
-		}
-		
-		for (unsigned int i = 0U; i < 3U; i++) {
-			dat_c <<= 1U;
-			if (READ_BIT(vch, 3U*(i + 24U) + 1U))
-				dat_c |= 0x01U;;
-		}
+	for (unsigned int j = 0U; j < 5U; j++, offset += 18U) {
 
-		for (unsigned int i = 0U; i < 22U; i++) {
-			dat_c <<= 1U;
-			if (READ_BIT(vch, i + 81U))
-				dat_c |= 0x01U;;
-		}
+		unsigned int dat_a, dat_b, dat_c, errors;
+		decodeVCH(data + offset, dat_a, dat_b, dat_c, errors);
 		
 		buf[pos]=0U;
 		buf[pos+1]=(unsigned char)(dat_a>>4);
@@ -887,72 +891,18 @@ void CModeConv::putYSF(unsigned char* data)
 
 	data += YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
 
-	unsigned int offset = 40U; // DCH(0)
-//    unsigned char buf[40];
-//	unsigned char pos=0;
+	unsigned int offset = 5U; // DCH(0)
 
 	// We have a total of 5 VCH sections, iterate through each
-	for (unsigned int j = 0U; j < 5U; j++, offset += 144U) {
-
-		unsigned char vch[13U];
-		unsigned int dat_a = 0U;
-		unsigned int dat_b = 0U;
-		unsigned int dat_c = 0U;
-
-		// Deinterleave
-		for (unsigned int i = 0U; i < 104U; i++) {
-			unsigned int n = INTERLEAVE_TABLE_26_4[i];
-			bool s = READ_BIT(data, offset + n);
-			WRITE_BIT(vch, i, s);
-		}
+	for (unsigned int j = 0U; j < 5U; j++, offset += 18U) {
 
-		// "Un-whiten" (descramble)
-		for (unsigned int i = 0U; i < 13U; i++)
-			vch[i] ^= WHITENING_DATA[i];
-	
-		for (unsigned int i = 0U; i < 12U; i++) {
-			dat_a <<= 1U;
-			if (READ_BIT(vch, 3U*i + 1U))
-				dat_a |= 0x01U;;
-		}
-		
-		for (unsigned int i = 0U; i < 12U; i++) {
-			dat_b <<= 1U;
-			if (READ_BIT(vch, 3U*(i + 12U) + 1U))
-				dat_b |= 0x01U;;
-		}
-		
-		for (unsigned int i = 0U; i < 3U; i++) {
-			dat_c <<= 1U;
-			if (READ_BIT(vch, 3U*(i + 24U) + 1U))
-				dat_c |= 0x01U;;
-		}
+		unsigned int dat_a, dat_b, dat_c, errors;
+		decodeVCH(data + offset, dat_a, dat_b, dat_c, errors);
 
-		for (unsigned int i = 0U; i < 22U; i++) {
-			dat_c <<= 1U;
-			if (READ_BIT(vch, i + 81U))
-				dat_c |= 0x01U;;
-		}
-		
-	/*	buf[pos]=0U;
-		buf[pos+1]=(unsigned char)(dat_a>>4);
-		unsigned char tmp=(unsigned char)((dat_a<<4)&0xF0);
-		tmp=tmp|(unsigned char)((dat_b>>8)&0x0F);
-        buf[pos+2]=tmp;
-        buf[pos+3]=(unsigned char)(dat_b&0xFF);
-        buf[pos+4]=(unsigned char)((dat_c&0x1FE0000)>>17);
-        buf[pos+5]=(unsigned char)((dat_c&0x1FE00)>>9);
-        buf[pos+6]=(unsigned char)((dat_c&0x1FE)>>1);
-		buf[pos+7]=(unsigned char) (dat_c&0x01);
-		pos+=8;
+		m_ysfStats.add(VCH_CHECKED_BITS, errors, 0U);
 
-		if (file == NULL) */
-			putAMBE2DMR(dat_a, dat_b, dat_c);
+		putAMBE2DMR(dat_a, dat_b, dat_c);
 	}
-   /* if (file) {
-		fwrite(buf,40U,1U,file);
-		//CUtils::dump(1U, "VCH V/D type 2:", buf, 40U);
-	} */
 }
 
 void CModeConv::putAMBE2DMR(unsigned int dat_a, unsigned int dat_b, unsigned int dat_c)
@@ -964,26 +914,9 @@ void CModeConv::putAMBE2DMR(unsigned int dat_a, unsigned int dat_b, unsigned int
 	unsigned int b = CGolay24128::encode23127(dat_b) >> 1;
 	b ^= p;
 
-	unsigned int MASK = 0x800000U;
-	for (unsigned int i = 0U; i < 24U; i++, MASK >>= 1) {
-		unsigned int aPos = DMR_A_TABLE[i];
-		WRITE_BIT(v_dmr, aPos, a & MASK);
-	}
+	encodeAMBE(a, b, dat_c, v_dmr);
 
-	MASK = 0x400000U;
-	for (unsigned int i = 0U; i < 23U; i++, MASK >>= 1) {
-		unsigned int bPos = DMR_B_TABLE[i];
-		WRITE_BIT(v_dmr, bPos, b & MASK);
-	}
-
-	MASK = 0x1000000U;
-	for (unsigned int i = 0U; i < 25U; i++, MASK >>= 1) {
-		unsigned int cPos = DMR_C_TABLE[i];
-		WRITE_BIT(v_dmr, cPos, dat_c & MASK);
-	}
-
-	m_DMR.addData(&TAG_DATA, 1U);
-	m_DMR.addData(v_dmr, 9U);
+	m_DMR.add(TAG_DATA, v_dmr, 9U);
 
 	//CUtils::dump(1U, "DMR Voice:", v_dmr, 9U);
 	
@@ -994,8 +927,7 @@ void CModeConv::putDummyYSF()
 {
 	// We have a total of 5 VCH sections
 	for (unsigned int j = 0U; j < 5U; j++) {
-		m_DMR.addData(&TAG_DATA, 1U);
-		m_DMR.addData(DMR_SILENCE, 9U);
+		m_DMR.add(TAG_DATA, DMR_SILENCE, 9U);
 
 		m_dmrN += 1U;
 	}
@@ -1007,8 +939,7 @@ void CModeConv::putDMRHeader()
 
 	::memset(vch, 0, 13U);
 
-	m_YSF.addData(&TAG_HEADER, 1U);
-	m_YSF.addData(vch, 13U);
+	m_YSF.add(TAG_HEADER, vch, 13U);
 	m_ysfN += 1U;
 }
 
@@ -1018,15 +949,13 @@ void CModeConv::putDMRHeaderV1()
 
 	::memset(vch, 0, 13U);
 
-	m_YSF.addData(&TAG_HEADERV1, 1U);
-	m_YSF.addData(vch, 13U);
+	m_YSF.add(TAG_HEADERV1, vch, 13U);
 	m_ysfN += 1U;
 }
 
 void CModeConv::putDMRSilence(void) {
 	for (unsigned int i = 0U; i < 5U; i++) {
-		m_YSF.addData(&TAG_DATA, 1U);
-		m_YSF.addData(YSF_SILENCE, 13U);
+		m_YSF.add(TAG_DATA, YSF_SILENCE, 13U);
 		m_ysfN += 1U;
 	}
 }
@@ -1035,8 +964,7 @@ void CModeConv::putBulk(unsigned char* data) {
 
 	assert (data != NULL);
 
-	m_YSF.addData(&TAG_BULK, 1U);
-	m_YSF.addData(data, 155U);
+	m_YSF.add(TAG_BULK, data, 155U);
 	m_ysfN += 5U;
 }
 
@@ -1049,13 +977,11 @@ void CModeConv::putDMREOT(bool do_fill)
 	if (do_fill) {
 		unsigned int fill = 5U - (m_ysfN % 5U);
 		for (unsigned int i = 0U; i < fill; i++) {
-			m_YSF.addData(&TAG_DATA, 1U);
-			m_YSF.addData(YSF_SILENCE, 13U);
+			m_YSF.add(TAG_DATA, YSF_SILENCE, 13U);
 			m_ysfN += 1U;
 		}
 	}
-	m_YSF.addData(&TAG_EOT, 1U);
-	m_YSF.addData(vch, 13U);
+	m_YSF.add(TAG_EOT, vch, 13U);
 	m_ysfN += 1U;
 }
 
@@ -1068,13 +994,11 @@ void CModeConv::putDMREOTV1(bool do_fill)
 	if (do_fill) {
 		unsigned int fill = 5U - (m_ysfN % 5U);
 		for (unsigned int i = 0U; i < fill; i++) {
-			m_YSF.addData(&TAG_DATAV1, 1U);
-			m_YSF.addData(DMR_SILENCE, 9U);
+			m_YSF.add(TAG_DATAV1, DMR_SILENCE, 9U);
 			m_ysfN += 1U;
 		}
 	}
-	m_YSF.addData(&TAG_EOTV1, 1U);
-	m_YSF.addData(vch, 13U);
+	m_YSF.add(TAG_EOTV1, vch, 13U);
 	m_ysfN += 1U;
 }
 
@@ -1084,8 +1008,7 @@ void CModeConv::putYSFHeader()
 
 	::memset(v_dmr, 0U, 9U);
 
-	m_DMR.addData(&TAG_HEADER, 1U);
-	m_DMR.addData(v_dmr, 9U);
+	m_DMR.add(TAG_HEADER, v_dmr, 9U);
 	m_dmrN += 1U;
 }
 
@@ -1097,13 +1020,11 @@ void CModeConv::putYSFEOT()
 	
 	unsigned int fill = 3U - (m_dmrN % 3U);
 	for (unsigned int i = 0U; i < fill; i++) {
-		m_DMR.addData(&TAG_DATA, 1U);
-		m_DMR.addData(DMR_SILENCE, 9U);
+		m_DMR.add(TAG_DATA, DMR_SILENCE, 9U);
 		m_dmrN += 1U;
 	}
 
-	m_DMR.addData(&TAG_EOT, 1U);
-	m_DMR.addData(v_dmr, 9U);
+	m_DMR.add(TAG_EOT, v_dmr, 9U);
 	m_dmrN += 1U;
 }
 
@@ -1115,23 +1036,20 @@ unsigned int CModeConv::getDMR(unsigned char* data)
 	tag[0U] = TAG_NODATA;
 
 	if (m_dmrN >= 1U) {
-		m_DMR.peek(tag, 1U);
+		tag[0U] = m_DMR.peek();
 
 		if (tag[0U] != TAG_DATA) {
-			m_DMR.getData(tag, 1U);
-			m_DMR.getData(data, 9U);
+			tag[0U] = m_DMR.get(data, 9U);
 			m_dmrN -= 1U;
 			return tag[0U];
 		}
 	}
 
 	if (m_dmrN >= 3U) {
-		m_DMR.getData(tag, 1U);
-		m_DMR.getData(data, 9U);
+		m_DMR.get(data, 9U);
 		m_dmrN -= 1U;
 
-		m_DMR.getData(tag, 1U);
-		m_DMR.getData(tmp, 9U);
+		m_DMR.get(tmp, 9U);
 		m_dmrN -= 1U;
 
 		::memcpy(data + 9U, tmp, 4U);
@@ -1139,8 +1057,7 @@ unsigned int CModeConv::getDMR(unsigned char* data)
 		data[19U] = tmp[4U] & 0x0FU;
 		::memcpy(data + 20U, tmp + 5U, 4U);
 
-		m_DMR.getData(tag, 1U);
-		m_DMR.getData(data + 24U, 9U);
+		m_DMR.get(data + 24U, 9U);
 		m_dmrN -= 1U;
 
 		return TAG_DATA;
@@ -1159,19 +1076,17 @@ unsigned int CModeConv::getYSF(unsigned char* data)
 	data += YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
 	
 	if (m_ysfN >= 1U) {
-		m_YSF.peek(tag, 1U);
+		tag[0U] = m_YSF.peek();
 
 		if (tag[0U] == TAG_BULK) {
 			data -= 65U;
-			m_YSF.getData(tag, 1U);
-			m_YSF.getData(data, 155U);
+			m_YSF.get(data, 155U);
 			m_ysfN -= 5U;
 			return TAG_BULK;			
 		}
 
 		if ((tag[0U] != TAG_DATA) && (tag[0U] != TAG_DATAV1)) {
-			m_YSF.getData(tag, 1U);
-			m_YSF.getData(data, 13U);
+			tag[0U] = m_YSF.get(data, 13U);
 			m_ysfN -= 1U;
 			return tag[0U];
 		}
@@ -1180,54 +1095,44 @@ unsigned int CModeConv::getYSF(unsigned char* data)
 	if (m_ysfN >= 5U) {
 		if (tag[0U] == TAG_DATA) {
 			data += 5U;
-			m_YSF.getData(tag, 1U);
-			m_YSF.getData(data, 13U);
+			m_YSF.get(data, 13U);
 			m_ysfN -= 1U;
 
 			data += 18U;
-			m_YSF.getData(tag, 1U);
-			m_YSF.getData(data, 13U);
+			m_YSF.get(data, 13U);
 			m_ysfN -= 1U;
 
 			data += 18U;
-			m_YSF.getData(tag, 1U);
-			m_YSF.getData(data, 13U);
+			m_YSF.get(data, 13U);
 			m_ysfN -= 1U;
 
 			data += 18U;
-			m_YSF.getData(tag, 1U);
-			m_YSF.getData(data, 13U);
+			m_YSF.get(data, 13U);
 			m_ysfN -= 1U;
 
 			data += 18U;
-			m_YSF.getData(tag, 1U);
-			m_YSF.getData(data, 13U);
+			m_YSF.get(data, 13U);
 			m_ysfN -= 1U;
 			return TAG_DATA;
 		} else if (tag[0U] == TAG_DATAV1) {
 			data += 9U;
-			m_YSF.getData(tag, 1U);
-			m_YSF.getData(data, 9U);
+			m_YSF.get(data, 9U);
 			m_ysfN -= 1U;
 
 			data += 18U;
-			m_YSF.getData(tag, 1U);
-			m_YSF.getData(data, 9U);
+			m_YSF.get(data, 9U);
 			m_ysfN -= 1U;
 
 			data += 18U;
-			m_YSF.getData(tag, 1U);
-			m_YSF.getData(data, 9U);
+			m_YSF.get(data, 9U);
 			m_ysfN -= 1U;
 
 			data += 18U;
-			m_YSF.getData(tag, 1U);
-			m_YSF.getData(data, 9U);
+			m_YSF.get(data, 9U);
 			m_ysfN -= 1U;
 
 			data += 18U;
-			m_YSF.getData(tag, 1U);
-			m_YSF.getData(data, 9U);
+			m_YSF.get(data, 9U);
 			m_ysfN -= 1U;	
 			return TAG_DATAV1;		
 		}
@@ -1241,8 +1146,7 @@ void CModeConv::putVCH(unsigned char * buffer) {
     buffer += 5U;
 
   for (unsigned int i=0; i < 5U; i++) {
-	m_YSF.addData(&TAG_DATA,1U);
-	m_YSF.addData(buffer,13U);
+	m_YSF.add(TAG_DATA, buffer, 13U);
 	buffer += 18U;
 	m_ysfN += 1U;
 	}
@@ -1254,16 +1158,14 @@ void CModeConv::putVCHV1(unsigned char * buffer) {
     buffer += 9U;
 
   for (unsigned int i=0; i < 5U; i++) {
-	m_YSF.addData(&TAG_DATAV1,1U);
-	m_YSF.addData(buffer,9U);
+	m_YSF.add(TAG_DATAV1, buffer, 9U);
 	buffer += 18U;
 	m_ysfN += 1U;
 	}
 }
 
 void CModeConv::putDCHV1(unsigned char * buffer) {
-	m_YSF.addData(&TAG_DCH,1U);
-	m_YSF.addData(buffer,20U);
+	m_YSF.add(TAG_DCH, buffer, 20U);
 }
 
 unsigned int CModeConv::getDCHV1(unsigned char * buffer) {
@@ -1273,11 +1175,10 @@ unsigned int CModeConv::getDCHV1(unsigned char * buffer) {
 
 	tag[0U] = TAG_NODATA;
 	if (m_YSF.isEmpty()) return tag[0U];
-	m_YSF.peek(tag, 1U);
+	tag[0U] = m_YSF.peek();
 	
 	if (tag[0U] == TAG_DCH) {
-		m_YSF.getData(tag, 1U);
-		m_YSF.getData(buffer, 20U);
+		tag[0U] = m_YSF.get(buffer, 20U);
 	}
 	return tag[0U];
 }
@@ -1289,6 +1190,26 @@ void CModeConv::reset(void){
 	m_dmrN=0;
 }
 
+const CFrameQueue& CModeConv::getYSFQueue() const
+{
+	return m_YSF;
+}
+
+const CFrameQueue& CModeConv::getDMRQueue() const
+{
+	return m_DMR;
+}
+
+void CModeConv::resetYSFQueueStats()
+{
+	m_YSF.resetStats();
+}
+
+void CModeConv::resetDMRQueueStats()
+{
+	m_DMR.resetStats();
+}
+
 char final_str[250];
 
 void CModeConv::LoadTable(unsigned int levelA, unsigned int levelB)
@@ -1331,3 +1252,23 @@ void CModeConv::LoadTable(unsigned int levelA, unsigned int levelB)
 	strcat(final_str,tmp_cad);
 	LogMessage(final_str);
 }
+
+const CFECStats& CModeConv::getDMRStats() const
+{
+	return m_dmrStats;
+}
+
+const CFECStats& CModeConv::getYSFStats() const
+{
+	return m_ysfStats;
+}
+
+void CModeConv::resetDMRStats()
+{
+	m_dmrStats.reset();
+}
+
+void CModeConv::resetYSFStats()
+{
+	m_ysfStats.reset();
+}
@@ -20,11 +20,17 @@
 
 #include "Defines.h"
 #include "YSFDefines.h"
-#include "RingBuffer.h"
+#include "FrameQueue.h"
+#include "FECStats.h"
+
+#include <cstdio>
 
 #if !defined(MODECONV_H)
 #define MODECONV_H
 
+// In AMBE frames, a little over twenty seconds of audio
+const unsigned int MODECONV_QUEUE_LENGTH = 1024U;
+
 class CModeConv {
 public:
 	CModeConv();
@@ -59,13 +65,37 @@ public:
 	
 	void reset(void);
 
+	// How full the DMR to YSF and YSF to DMR queues are, in records
+	const CFrameQueue& getYSFQueue() const;
+	const CFrameQueue& getDMRQueue() const;
+	void resetYSFQueueStats();
+	void resetDMRQueueStats();
+
+	// What the FEC found in the DMR AMBE given to putDMR() and the VCHs given
+	// to putYSF(), until reset
+	const CFECStats& getDMRStats() const;
+	const CFECStats& getYSFStats() const;
+	void resetDMRStats();
+	void resetYSFStats();
+
+	// The bit layouts of the AMBE frames, public for ModeConvCheck. The 33
+	// byte DMR burst holds three frames, the middle one split by the sync.
+	static void decodeDMR(const unsigned char* bytes, unsigned int* a, unsigned int* b, unsigned int* c);
+	static void decodeAMBE(const unsigned char* in, unsigned int& a, unsigned int& b, unsigned int& c);
+	static void encodeAMBE(unsigned int a, unsigned int b, unsigned int c, unsigned char* out);
+	static void decodeVCH(const unsigned char* in, unsigned int& dat_a, unsigned int& dat_b, unsigned int& dat_c, unsigned int& errors);
+	static void encodeVCH(unsigned int dat_a, unsigned int dat_b, unsigned int dat_c, unsigned char* out);
+
 private:
+	void checkAMBE(unsigned int a, unsigned int b);
 	void putAMBE2YSF(unsigned int a, unsigned int b, unsigned int dat_c);
 	void putAMBE2DMR(unsigned int dat_a, unsigned int dat_b, unsigned int dat_c);
 	unsigned int m_ysfN;
 	unsigned int m_dmrN;
-	CRingBuffer<unsigned char> m_YSF;
-	CRingBuffer<unsigned char> m_DMR;
+	CFrameQueue m_YSF;
+	CFrameQueue m_DMR;
+	CFECStats   m_dmrStats;
+	CFECStats   m_ysfStats;
 	unsigned char m_ctable[32];
 
 };
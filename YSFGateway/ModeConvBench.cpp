@@ -0,0 +1,188 @@
+/*
+ *   Copyright (C) 2026 by agent
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Measures the YSF to DMR and DMR to YSF conversions in CModeConv, away from
+// the network. The input is an .amb recording as written by
+// CStreamer::AMBE_write(), 40 bytes per YSF frame, or generated AMBE when no
+// file is given. The recording is turned into YSF V/D mode 2 frames, and
+// those into DMR voice bursts, before anything is timed.
+
+#include "ModeConv.h"
+#include "StopWatch.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+const unsigned int AMBE_RECORD_LENGTH = 40U;
+const unsigned int DMR_BURST_LENGTH   = 33U;
+const unsigned int DEFAULT_ITERATIONS = 200U;
+const unsigned int GENERATED_FRAMES   = 1000U;
+
+static unsigned long long allocations = 0ULL;
+
+void* operator new(size_t size)
+{
+	allocations++;
+
+	void* p = ::malloc(size > 0U ? size : 1U);
+	if (p == NULL)
+		throw std::bad_alloc();
+
+	return p;
+}
+
+void operator delete(void* p) throw()
+{
+	::free(p);
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete[](void* p) throw()
+{
+	operator delete(p);
+}
+
+static void report(const char* name, unsigned long long frames, unsigned long long micros, unsigned long long allocs)
+{
+	double seconds = double(micros) / 1000000.0;
+	double rate    = seconds > 0.0 ? double(frames) / seconds : 0.0;
+	double ns      = frames > 0ULL ? double(micros) * 1000.0 / double(frames) : 0.0;
+	double each    = frames > 0ULL ? double(allocs) / double(frames) : 0.0;
+
+	::fprintf(stdout, "%-10s %10llu frames %8.3f s %12.0f frames/s %10.1f ns/frame %10llu allocations (%.3f/frame)\n", name, frames, seconds, rate, ns, allocs, each);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 3) {
+		::fprintf(stderr, "Usage: ModeConvBench [file.amb] [iterations]\n");
+		return 1;
+	}
+
+	unsigned int iterations = DEFAULT_ITERATIONS;
+	if (argc > 2)
+		iterations = (unsigned int)::atoi(argv[2]);
+
+	std::vector<unsigned char> ambe;
+
+	if (argc > 1) {
+		FILE* fp = ::fopen(argv[1], "rb");
+		if (fp == NULL) {
+			::fprintf(stderr, "ModeConvBench: cannot open %s\n", argv[1]);
+			return 1;
+		}
+
+		unsigned char record[AMBE_RECORD_LENGTH];
+		while (::fread(record, 1U, AMBE_RECORD_LENGTH, fp) == AMBE_RECORD_LENGTH)
+			ambe.insert(ambe.end(), record, record + AMBE_RECORD_LENGTH);
+
+		::fclose(fp);
+	} else {
+		// The same frames every run, so that results can be compared
+		unsigned int seed = 1U;
+		ambe.resize(GENERATED_FRAMES * AMBE_RECORD_LENGTH);
+		for (unsigned int i = 0U; i < ambe.size(); i++) {
+			seed = seed * 1103515245U + 12345U;
+			ambe[i] = (i % 8U) == 0U ? 0x00U : (unsigned char)(seed >> 16);
+		}
+	}
+
+	unsigned int records = ambe.size() / AMBE_RECORD_LENGTH;
+	if (records == 0U || iterations == 0U) {
+		::fprintf(stderr, "ModeConvBench: nothing to convert\n");
+		return 1;
+	}
+
+	CModeConv conv;
+	conv.LoadTable(0U, 0U);
+
+	// Build the YSF V/D mode 2 frames, five AMBE frames to each
+	std::vector<unsigned char> ysf;
+	unsigned char frame[YSF_FRAME_LENGTH_BYTES];
+	for (unsigned int i = 0U; i < records; i++) {
+		for (unsigned int j = 0U; j < 5U; j++)
+			conv.AMB2YSF_Mode2(&ambe[i * AMBE_RECORD_LENGTH + j * 8U]);
+
+		::memset(frame, 0x00U, YSF_FRAME_LENGTH_BYTES);
+		if (conv.getYSF(frame) == TAG_DATA)
+			ysf.insert(ysf.end(), frame, frame + YSF_FRAME_LENGTH_BYTES);
+	}
+
+	unsigned int ysfFrames = ysf.size() / YSF_FRAME_LENGTH_BYTES;
+
+	// And the DMR voice bursts, three AMBE frames to each
+	std::vector<unsigned char> dmr;
+	unsigned char burst[DMR_BURST_LENGTH];
+	for (unsigned int i = 0U; i < ysfFrames; i++) {
+		conv.putYSF(&ysf[i * YSF_FRAME_LENGTH_BYTES]);
+
+		while (conv.getDMR(burst) == TAG_DATA)
+			dmr.insert(dmr.end(), burst, burst + DMR_BURST_LENGTH);
+	}
+
+	unsigned int dmrBursts = dmr.size() / DMR_BURST_LENGTH;
+
+	conv.reset();
+
+	::fprintf(stdout, "%u AMBE records, %u YSF frames, %u DMR bursts, %u iterations\n", records, ysfFrames, dmrBursts, iterations);
+
+	CStopWatch stopWatch;
+
+	unsigned long long allocs = allocations;
+	unsigned long long start  = stopWatch.micros();
+	unsigned long long out    = 0ULL;
+
+	for (unsigned int n = 0U; n < iterations; n++) {
+		for (unsigned int i = 0U; i < ysfFrames; i++) {
+			conv.putYSF(&ysf[i * YSF_FRAME_LENGTH_BYTES]);
+
+			while (conv.getDMR(burst) == TAG_DATA)
+				out++;
+		}
+	}
+
+	report("YSF->DMR", (unsigned long long)ysfFrames * iterations, stopWatch.micros() - start, allocations - allocs);
+
+	conv.reset();
+
+	allocs = allocations;
+	start  = stopWatch.micros();
+
+	for (unsigned int n = 0U; n < iterations; n++) {
+		for (unsigned int i = 0U; i < dmrBursts; i++) {
+			conv.putDMR(&dmr[i * DMR_BURST_LENGTH]);
+
+			while (conv.getYSF(frame) == TAG_DATA)
+				out++;
+		}
+	}
+
+	report("DMR->YSF", (unsigned long long)dmrBursts * iterations, stopWatch.micros() - start, allocations - allocs);
+
+	// Keeps the output live, and shows that the conversions produced something
+	::fprintf(stdout, "%llu frames out\n", out);
+
+	return 0;
+}
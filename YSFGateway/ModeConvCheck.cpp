@@ -0,0 +1,410 @@
+/*
+ *   Copyright (C) 2026 by agent
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks the byte table AMBE frame layouts in CModeConv against the bit by
+// bit code they replaced, kept here as it was, on the same frames. The frames
+// are pseudo random, the same every run, along with all zeros, all ones and
+// every single bit set. Any difference is reported and fails the run.
+
+#include "ModeConv.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const unsigned int DEFAULT_FRAMES = 200000U;
+
+const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
+
+#define WRITE_BIT(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
+#define READ_BIT(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
+
+const unsigned int DMR_A_TABLE[] = {0U,  4U,  8U, 12U, 16U, 20U, 24U, 28U, 32U, 36U, 40U, 44U,
+									48U, 52U, 56U, 60U, 64U, 68U,  1U,  5U,  9U, 13U, 17U, 21U};
+const unsigned int DMR_B_TABLE[] = {25U, 29U, 33U, 37U, 41U, 45U, 49U, 53U, 57U, 61U, 65U, 69U,
+									 2U,  6U, 10U, 14U, 18U, 22U, 26U, 30U, 34U, 38U, 42U};
+const unsigned int DMR_C_TABLE[] = {46U, 50U, 54U, 58U, 62U, 66U, 70U,  3U,  7U, 11U, 15U, 19U, 23U,
+									27U, 31U, 35U, 39U, 43U, 47U, 51U, 55U, 59U, 63U, 67U, 71U};
+
+const unsigned int INTERLEAVE_TABLE_26_4[] = {
+	0U, 4U,  8U, 12U, 16U, 20U, 24U, 28U, 32U, 36U, 40U, 44U, 48U, 52U, 56U, 60U, 64U, 68U, 72U, 76U, 80U, 84U, 88U, 92U, 96U, 100U,
+	1U, 5U,  9U, 13U, 17U, 21U, 25U, 29U, 33U, 37U, 41U, 45U, 49U, 53U, 57U, 61U, 65U, 69U, 73U, 77U, 81U, 85U, 89U, 93U, 97U, 101U,
+	2U, 6U, 10U, 14U, 18U, 22U, 26U, 30U, 34U, 38U, 42U, 46U, 50U, 54U, 58U, 62U, 66U, 70U, 74U, 78U, 82U, 86U, 90U, 94U, 98U, 102U,
+	3U, 7U, 11U, 15U, 19U, 23U, 27U, 31U, 35U, 39U, 43U, 47U, 51U, 55U, 59U, 63U, 67U, 71U, 75U, 79U, 83U, 87U, 91U, 95U, 99U, 103U};
+
+const unsigned char WHITENING_DATA[] = {0x93U, 0xD7U, 0x51U, 0x21U, 0x9CU, 0x2FU, 0x6CU, 0xD0U, 0xEFU, 0x0FU,
+										0xF8U, 0x3DU, 0xF1U, 0x73U, 0x20U, 0x94U, 0xEDU, 0x1EU, 0x7CU, 0xD8U};
+
+// From putDMR()
+static void oldDecodeDMR(const unsigned char* bytes, unsigned int* a, unsigned int* b, unsigned int* c)
+{
+	for (unsigned int n = 0U; n < 3U; n++) {
+		a[n] = 0U;
+		b[n] = 0U;
+		c[n] = 0U;
+	}
+
+	unsigned int MASK = 0x800000U;
+	for (unsigned int i = 0U; i < 24U; i++, MASK >>= 1) {
+		unsigned int a1Pos = DMR_A_TABLE[i];
+		unsigned int a2Pos = a1Pos + 72U;
+		if (a2Pos >= 108U)
+			a2Pos += 48U;
+		unsigned int a3Pos = a1Pos + 192U;
+
+		if (READ_BIT(bytes, a1Pos))
+			a[0U] |= MASK;
+		if (READ_BIT(bytes, a2Pos))
+			a[1U] |= MASK;
+		if (READ_BIT(bytes, a3Pos))
+			a[2U] |= MASK;
+	}
+
+	MASK = 0x400000U;
+	for (unsigned int i = 0U; i < 23U; i++, MASK >>= 1) {
+		unsigned int b1Pos = DMR_B_TABLE[i];
+		unsigned int b2Pos = b1Pos + 72U;
+		if (b2Pos >= 108U)
+			b2Pos += 48U;
+		unsigned int b3Pos = b1Pos + 192U;
+
+		if (READ_BIT(bytes, b1Pos))
+			b[0U] |= MASK;
+		if (READ_BIT(bytes, b2Pos))
+			b[1U] |= MASK;
+		if (READ_BIT(bytes, b3Pos))
+			b[2U] |= MASK;
+	}
+
+	MASK = 0x1000000U;
+	for (unsigned int i = 0U; i < 25U; i++, MASK >>= 1) {
+		unsigned int c1Pos = DMR_C_TABLE[i];
+		unsigned int c2Pos = c1Pos + 72U;
+		if (c2Pos >= 108U)
+			c2Pos += 48U;
+		unsigned int c3Pos = c1Pos + 192U;
+
+		if (READ_BIT(bytes, c1Pos))
+			c[0U] |= MASK;
+		if (READ_BIT(bytes, c2Pos))
+			c[1U] |= MASK;
+		if (READ_BIT(bytes, c3Pos))
+			c[2U] |= MASK;
+	}
+}
+
+// From putYSF_Mode1()
+static void oldDecodeAMBE(const unsigned char* data, unsigned int& a, unsigned int& b, unsigned int& dat_c)
+{
+	a = 0U;
+	unsigned int MASK = 0x800000U;
+	for (unsigned int i = 0U; i < 24U; i++, MASK >>= 1) {
+		unsigned int aPos = DMR_A_TABLE[i];
+		if (READ_BIT(data, aPos))
+			a |= MASK;
+	}
+
+	b = 0U;
+	MASK = 0x400000U;
+	for (unsigned int i = 0U; i < 23U; i++, MASK >>= 1) {
+		unsigned int bPos = DMR_B_TABLE[i];
+		if (READ_BIT(data, bPos))
+			b |= MASK;
+	}
+
+	dat_c = 0U;
+	MASK = 0x1000000U;
+	for (unsigned int i = 0U; i < 25U; i++, MASK >>= 1) {
+		unsigned int cPos = DMR_C_TABLE[i];
+		if (READ_BIT(data, cPos))
+			dat_c |= MASK;
+	}
+}
+
+// From putAMBE2DMR() and AMB2YSF_Mode1()
+static void oldEncodeAMBE(unsigned int a, unsigned int b, unsigned int dat_c, unsigned char* v_dmr)
+{
+	::memset(v_dmr, 0x00U, 9U);
+
+	unsigned int MASK = 0x800000U;
+	for (unsigned int i = 0U; i < 24U; i++, MASK >>= 1) {
+		unsigned int aPos = DMR_A_TABLE[i];
+		WRITE_BIT(v_dmr, aPos, a & MASK);
+	}
+
+	MASK = 0x400000U;
+	for (unsigned int i = 0U; i < 23U; i++, MASK >>= 1) {
+		unsigned int bPos = DMR_B_TABLE[i];
+		WRITE_BIT(v_dmr, bPos, b & MASK);
+	}
+
+	MASK = 0x1000000U;
+	for (unsigned int i = 0U; i < 25U; i++, MASK >>= 1) {
+		unsigned int cPos = DMR_C_TABLE[i];
+		WRITE_BIT(v_dmr, cPos, dat_c & MASK);
+	}
+}
+
+// From putYSF() and putYSF_Mode2(), with the disagreeing triples counted
+static void oldDecodeVCH(const unsigned char* data, unsigned int& dat_a, unsigned int& dat_b, unsigned int& dat_c, unsigned int& errors)
+{
+	unsigned char vch[13U];
+	dat_a = 0U;
+	dat_b = 0U;
+	dat_c = 0U;
+
+	// Deinterleave
+	for (unsigned int i = 0U; i < 104U; i++) {
+		unsigned int n = INTERLEAVE_TABLE_26_4[i];
+		bool s = READ_BIT(data, n);
+		WRITE_BIT(vch, i, s);
+	}
+
+	// "Un-whiten" (descramble)
+	for (unsigned int i = 0U; i < 13U; i++)
+		vch[i] ^= WHITENING_DATA[i];
+
+	for (unsigned int i = 0U; i < 12U; i++) {
+		dat_a <<= 1U;
+		if (READ_BIT(vch, 3U*i + 1U))
+			dat_a |= 0x01U;
+	}
+
+	for (unsigned int i = 0U; i < 12U; i++) {
+		dat_b <<= 1U;
+		if (READ_BIT(vch, 3U*(i + 12U) + 1U))
+			dat_b |= 0x01U;
+	}
+
+	for (unsigned int i = 0U; i < 3U; i++) {
+		dat_c <<= 1U;
+		if (READ_BIT(vch, 3U*(i + 24U) + 1U))
+			dat_c |= 0x01U;
+	}
+
+	for (unsigned int i = 0U; i < 22U; i++) {
+		dat_c <<= 1U;
+		if (READ_BIT(vch, i + 81U))
+			dat_c |= 0x01U;
+	}
+
+	errors = 0U;
+	for (unsigned int i = 0U; i < 27U; i++) {
+		bool s0 = READ_BIT(vch, 3U*i + 0U) != 0;
+		bool s1 = READ_BIT(vch, 3U*i + 1U) != 0;
+		bool s2 = READ_BIT(vch, 3U*i + 2U) != 0;
+		if (s0 != s1 || s1 != s2)
+			errors++;
+	}
+}
+
+// From putAMBE2YSF() and AMB2YSF_Mode2()
+static void oldEncodeVCH(unsigned int dat_a, unsigned int dat_b, unsigned int dat_c, unsigned char* ysfFrame)
+{
+	unsigned char vch[13U];
+	::memset(vch, 0U, 13U);
+	::memset(ysfFrame, 0, 13U);
+
+	for (unsigned int i = 0U; i < 12U; i++) {
+		bool s = (dat_a << (20U + i)) & 0x80000000U;
+		WRITE_BIT(vch, 3*i + 0U, s);
+		WRITE_BIT(vch, 3*i + 1U, s);
+		WRITE_BIT(vch, 3*i + 2U, s);
+	}
+
+	for (unsigned int i = 0U; i < 12U; i++) {
+		bool s = (dat_b << (20U + i)) & 0x80000000U;
+		WRITE_BIT(vch, 3*(i + 12U) + 0U, s);
+		WRITE_BIT(vch, 3*(i + 12U) + 1U, s);
+		WRITE_BIT(vch, 3*(i + 12U) + 2U, s);
+	}
+
+	for (unsigned int i = 0U; i < 3U; i++) {
+		bool s = (dat_c << (7U + i)) & 0x80000000U;
+		WRITE_BIT(vch, 3*(i + 24U) + 0U, s);
+		WRITE_BIT(vch, 3*(i + 24U) + 1U, s);
+		WRITE_BIT(vch, 3*(i + 24U) + 2U, s);
+	}
+
+	for (unsigned int i = 0U; i < 22U; i++) {
+		bool s = (dat_c << (10U + i)) & 0x80000000U;
+		WRITE_BIT(vch, i + 81U, s);
+	}
+
+	WRITE_BIT(vch, 103U, 0U);
+
+	// Scramble
+	for (unsigned int i = 0U; i < 13U; i++)
+		vch[i] ^= WHITENING_DATA[i];
+
+	// Interleave
+	for (unsigned int i = 0U; i < 104U; i++) {
+		unsigned int n = INTERLEAVE_TABLE_26_4[i];
+		bool s = READ_BIT(vch, i);
+		WRITE_BIT(ysfFrame, n, s);
+	}
+}
+
+class CFrameSource {
+public:
+	CFrameSource() :
+	m_seed(1U)
+	{
+	}
+
+	// All zeros, all ones, each single bit, then pseudo random
+	void frame(unsigned int n, unsigned char* frame, unsigned int length)
+	{
+		if (n == 0U) {
+			::memset(frame, 0x00U, length);
+		} else if (n == 1U) {
+			::memset(frame, 0xFFU, length);
+		} else if (n - 2U < length * 8U) {
+			::memset(frame, 0x00U, length);
+			WRITE_BIT(frame, n - 2U, true);
+		} else {
+			for (unsigned int i = 0U; i < length; i++)
+				frame[i] = (unsigned char)(random() >> 16);
+		}
+	}
+
+	// The same for a value of the given width
+	unsigned int value(unsigned int n, unsigned int bits)
+	{
+		unsigned int mask = bits < 32U ? (1U << bits) - 1U : 0xFFFFFFFFU;
+
+		if (n == 0U)
+			return 0U;
+		else if (n == 1U)
+			return mask;
+		else if (n - 2U < bits)
+			return 1U << (n - 2U);
+		else
+			return ((random() << 8) ^ random()) & mask;
+	}
+
+private:
+	unsigned int m_seed;
+
+	unsigned int random()
+	{
+		m_seed = m_seed * 1103515245U + 12345U;
+		return m_seed;
+	}
+};
+
+static bool report(const char* name, unsigned int frames, unsigned int differences)
+{
+	::fprintf(stdout, "%-12s %10u frames %10u differences\n", name, frames, differences);
+
+	return differences == 0U;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 2) {
+		::fprintf(stderr, "Usage: ModeConvCheck [frames]\n");
+		return 1;
+	}
+
+	unsigned int frames = DEFAULT_FRAMES;
+	if (argc > 1)
+		frames = (unsigned int)::atoi(argv[1]);
+
+	CFrameSource source;
+	bool ok = true;
+
+	unsigned int differences = 0U;
+	for (unsigned int n = 0U; n < frames; n++) {
+		unsigned char burst[33U];
+		source.frame(n, burst, 33U);
+
+		unsigned int a1[3U], b1[3U], c1[3U];
+		unsigned int a2[3U], b2[3U], c2[3U];
+		oldDecodeDMR(burst, a1, b1, c1);
+		CModeConv::decodeDMR(burst, a2, b2, c2);
+
+		for (unsigned int i = 0U; i < 3U; i++) {
+			if (a1[i] != a2[i] || b1[i] != b2[i] || c1[i] != c2[i]) {
+				differences++;
+				break;
+			}
+		}
+	}
+	ok = report("decodeDMR", frames, differences) && ok;
+
+	differences = 0U;
+	for (unsigned int n = 0U; n < frames; n++) {
+		unsigned char frame[9U];
+		source.frame(n, frame, 9U);
+
+		unsigned int a1, b1, c1, a2, b2, c2;
+		oldDecodeAMBE(frame, a1, b1, c1);
+		CModeConv::decodeAMBE(frame, a2, b2, c2);
+
+		if (a1 != a2 || b1 != b2 || c1 != c2)
+			differences++;
+	}
+	ok = report("decodeAMBE", frames, differences) && ok;
+
+	differences = 0U;
+	for (unsigned int n = 0U; n < frames; n++) {
+		unsigned int a = source.value(n, 24U);
+		unsigned int b = source.value(n, 23U);
+		unsigned int c = source.value(n, 25U);
+
+		unsigned char frame1[9U], frame2[9U];
+		oldEncodeAMBE(a, b, c, frame1);
+		CModeConv::encodeAMBE(a, b, c, frame2);
+
+		if (::memcmp(frame1, frame2, 9U) != 0)
+			differences++;
+	}
+	ok = report("encodeAMBE", frames, differences) && ok;
+
+	differences = 0U;
+	for (unsigned int n = 0U; n < frames; n++) {
+		unsigned char frame[13U];
+		source.frame(n, frame, 13U);
+
+		unsigned int a1, b1, c1, e1, a2, b2, c2, e2;
+		oldDecodeVCH(frame, a1, b1, c1, e1);
+		CModeConv::decodeVCH(frame, a2, b2, c2, e2);
+
+		if (a1 != a2 || b1 != b2 || c1 != c2 || e1 != e2)
+			differences++;
+	}
+	ok = report("decodeVCH", frames, differences) && ok;
+
+	differences = 0U;
+	for (unsigned int n = 0U; n < frames; n++) {
+		unsigned int a = source.value(n, 12U);
+		unsigned int b = source.value(n, 12U);
+		unsigned int c = source.value(n, 25U);
+
+		unsigned char frame1[13U], frame2[13U];
+		oldEncodeVCH(a, b, c, frame1);
+		CModeConv::encodeVCH(a, b, c, frame2);
+
+		if (::memcmp(frame1, frame2, 13U) != 0)
+			differences++;
+	}
+	ok = report("encodeVCH", frames, differences) && ok;
+
+	return ok ? 0 : 1;
+}
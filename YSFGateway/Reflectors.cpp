@@ -20,40 +20,61 @@
 #include "Log.h"
 
 #include <algorithm>
-#include <functional>
 #include <cstdio>
 #include <cassert>
 #include <cstring>
 #include <cctype>
 
+// Seconds for the background lookups of a list, any hosts left after that
+// are looked up when they are used
+const unsigned int RESOLVE_TIMEOUT = 60U;
+
+const char     CACHE_MAGIC[] = "YSFGWREF";
+const uint32_t CACHE_VERSION = 1U;
+
+// One reflector in the cache, the strings are offsets into the pool after
+// the records
+struct CReflectorRecord {
+	uint32_t m_id;
+	uint32_t m_name;
+	uint32_t m_desc;
+	uint32_t m_count;
+	uint32_t m_host;
+	uint32_t m_port;
+	uint32_t m_type;
+	uint32_t m_opt;
+};
+
 char const *atext_type[7] = {"NONE","YSF ","FCS ","DMR ","DMR+","NXDN","P25 "};
 
 CReflectors::CReflectors(const std::string& hostsFile, TG_TYPE type, unsigned int reloadTime, bool makeUpper) :
+CThread(),
 m_hostsFile(hostsFile),
-m_newReflectors(),
-m_currReflectors(),
+m_cacheFile(),
+m_newReflectors(NULL),
+m_currReflectors(new CReflectorList),
 m_search(),
 m_makeUpper(makeUpper),
-m_timer(1000U, reloadTime * 60U),
+m_reloadTime(reloadTime),
 m_type(type),
-m_parrotAddress(NULL)
+m_parrotAddress(NULL),
+m_parrotPort(0U),
+m_resolver(NULL),
+m_running(false),
+m_stop(false)
 {
-	if (reloadTime > 0U)
-		m_timer.start();
-	
 	m_type_str = atext_type[(int)type];
 }
 
 CReflectors::~CReflectors()
 {
-	for (std::vector<CReflector*>::iterator it = m_newReflectors.begin(); it != m_newReflectors.end(); ++it)
-		delete *it;
-
-	for (std::vector<CReflector*>::iterator it = m_currReflectors.begin(); it != m_currReflectors.end(); ++it)
-		delete *it;
+	if (m_running) {
+		m_stop = true;
+		wait();
+	}
 
-	m_newReflectors.clear();
-	m_currReflectors.clear();
+	delete m_newReflectors.exchange(NULL);
+	delete m_currReflectors;
 }
 
 static bool refComparison(const CReflector* r1, const CReflector* r2)
@@ -73,13 +94,174 @@ static bool refComparison(const CReflector* r1, const CReflector* r2)
 	return false;
 }
 
-bool CReflectors::load()
+static unsigned int pieceKey(const char* text, unsigned int length)
+{
+	unsigned int key = length << 24;
+
+	for (unsigned int i = 0U; i < length; i++)
+		key |= (unsigned char)text[i] << (16U - i * 8U);
+
+	return key;
+}
+
+// Upper cased without the trailing spaces, as search() is given its text
+static std::string searchKey(const std::string& name)
 {
-	for (std::vector<CReflector*>::iterator it = m_newReflectors.begin(); it != m_newReflectors.end(); ++it)
+	std::string key = name;
+
+	std::string::size_type n = key.size();
+	while (n > 0U && ::isspace((unsigned char)key[n - 1U]))
+		n--;
+	key.erase(n);
+
+	std::transform(key.begin(), key.end(), key.begin(), ::toupper);
+
+	return key;
+}
+
+CReflectorList::CReflectorList() :
+m_reflectors(),
+m_ids(),
+m_names(),
+m_keys(),
+m_pieces()
+{
+}
+
+CReflectorList::~CReflectorList()
+{
+	for (std::vector<CReflector*>::iterator it = m_reflectors.begin(); it != m_reflectors.end(); ++it)
 		delete *it;
+}
 
-	m_newReflectors.clear();
+void CReflectorList::add(CReflector* reflector)
+{
+	assert(reflector != NULL);
+
+	m_reflectors.push_back(reflector);
+}
+
+void CReflectorList::index()
+{
+	std::sort(m_reflectors.begin(), m_reflectors.end(), refComparison);
+
+	m_keys.reserve(m_reflectors.size());
+
+	for (unsigned int n = 0U; n < m_reflectors.size(); n++) {
+		CReflector* reflector = m_reflectors.at(n);
+
+		// The first of any repeats wins, as it did when the list was scanned
+		m_ids.insert(std::make_pair(reflector->m_id, reflector));
+		m_names.insert(std::make_pair(reflector->m_name, reflector));
+
+		m_keys.push_back(searchKey(reflector->m_name));
+
+		const std::string& key = m_keys.back();
+		for (unsigned int length = 1U; length <= 3U; length++) {
+			for (unsigned int i = 0U; i + length <= key.size(); i++) {
+				std::vector<unsigned int>& positions = m_pieces[pieceKey(key.c_str() + i, length)];
+				if (positions.empty() || positions.back() != n)
+					positions.push_back(n);
+			}
+		}
+	}
+}
+
+CReflector* CReflectorList::findById(const std::string& id) const
+{
+	std::unordered_map<std::string, CReflector*>::const_iterator it = m_ids.find(id);
+
+	return it != m_ids.end() ? it->second : NULL;
+}
+
+CReflector* CReflectorList::findByName(const std::string& name) const
+{
+	std::unordered_map<std::string, CReflector*>::const_iterator it = m_names.find(name);
+
+	return it != m_names.end() ? it->second : NULL;
+}
 
+void CReflectorList::search(const std::string& text, std::vector<CReflector*>& found) const
+{
+	found.clear();
+
+	if (text.empty()) {
+		found = m_reflectors;
+		return;
+	}
+
+	// Up to three characters the index is the answer, beyond that the shortest
+	// list of any of the three character pieces is checked against the text
+	unsigned int length = text.size() < 3U ? text.size() : 3U;
+
+	const std::vector<unsigned int>* shortest = NULL;
+	for (unsigned int i = 0U; i + length <= text.size(); i++) {
+		std::unordered_map<unsigned int, std::vector<unsigned int> >::const_iterator it = m_pieces.find(pieceKey(text.c_str() + i, length));
+		if (it == m_pieces.end())
+			return;
+
+		if (shortest == NULL || it->second.size() < shortest->size())
+			shortest = &it->second;
+	}
+
+	for (std::vector<unsigned int>::const_iterator it = shortest->begin(); it != shortest->end(); ++it) {
+		if (length < 3U || text.size() == 3U || m_keys.at(*it).find(text) != std::string::npos)
+			found.push_back(m_reflectors.at(*it));
+	}
+}
+
+void CReflectors::setCachePath(const std::string& path)
+{
+	static const char* SUFFIXES[] = {"none.cache", "ysf.cache", "fcs.cache", "dmr.cache", "dmrp.cache", "p25.cache", "nxdn.cache"};
+
+	m_cacheFile = path.empty() ? std::string() : CBinaryCache::fileName(path, m_hostsFile, SUFFIXES[m_type]);
+}
+
+bool CReflectors::read()
+{
+	bool ret = load();
+
+	if (m_reloadTime > 0U)
+		m_running = run();
+
+	return ret;
+}
+
+bool CReflectors::load()
+{
+	CReflectorList* reflectors = parse();
+	if (reflectors == NULL)
+		return false;
+
+	use(reflectors);
+
+	return true;
+}
+
+void CReflectors::entry()
+{
+	CTimer timer(1000U, 60U * m_reloadTime);
+	timer.start();
+
+	// Short sleeps so that the destructor is not kept waiting
+	while (!m_stop) {
+		sleep(100U);
+
+		timer.clock(100U);
+		if (timer.hasExpired()) {
+			CReflectorList* reflectors = parse();
+
+			// Replaces any list that clock() has not taken yet
+			if (reflectors != NULL)
+				delete m_newReflectors.exchange(reflectors);
+
+			timer.start();
+		}
+	}
+}
+
+void CReflectors::readText(std::vector<CReflector*>& reflectors)
+{
 	FILE* fp = ::fopen(m_hostsFile.c_str(), "rt");
 	if (fp != NULL) {
 		char buffer[100U];
@@ -96,25 +278,20 @@ bool CReflectors::load()
 				char* p6 = ::strtok(NULL, ";\r\n");
 
 				if (p1 != NULL && p2 != NULL && p3 != NULL && p4 != NULL && p5 != NULL && p6 != NULL) {
-					std::string host = std::string(p4);
-
-					in_addr address = CUDPSocket::lookup(host);
-					if (address.s_addr != INADDR_NONE) {
-						CReflector* refl = new CReflector;
-						unsigned int tmp = atoi(p1);
-
-						refl->m_id 	= std::to_string(tmp);
-						refl->m_name    = std::string(p2);
-						refl->m_desc    = std::string(p3);
-						refl->m_address = address;
-						refl->m_port    = (unsigned int)::atoi(p5);
-						refl->m_count   = std::string(p6);
-						refl->m_type    = YSF;
-						refl->m_opt 	= 0;
-						refl->m_name.resize(16U, ' ');
-						refl->m_desc.resize(14U, ' ');
-						m_newReflectors.push_back(refl);
-					}
+					CReflector* refl = new CReflector;
+					unsigned int tmp = atoi(p1);
+
+					refl->m_id 	= std::to_string(tmp);
+					refl->m_name    = std::string(p2);
+					refl->m_desc    = std::string(p3);
+					refl->m_host    = std::string(p4);
+					refl->m_port    = (unsigned int)::atoi(p5);
+					refl->m_count   = std::string(p6);
+					refl->m_type    = YSF;
+					refl->m_opt 	= 0;
+					refl->m_name.resize(16U, ' ');
+					refl->m_desc.resize(14U, ' ');
+					reflectors.push_back(refl);
 				}
 			} else if (m_type==FCS) {
 				char* p1 = ::strtok(buffer, ";\r\n");
@@ -139,7 +316,7 @@ bool CReflectors::load()
 					refl->m_opt 	= 0;
 					refl->m_name.resize(16U, ' ');
 					refl->m_desc.resize(14U, ' ');
-					m_newReflectors.push_back(refl);
+					reflectors.push_back(refl);
 					}
 
 			} else if ((m_type==NXDN) || (m_type==P25)) {
@@ -158,7 +335,7 @@ bool CReflectors::load()
 					refl->m_opt 	= 0;
 					refl->m_name.resize(16U, ' ');
 					refl->m_desc.resize(14U, ' ');
-					m_newReflectors.push_back(refl);
+					reflectors.push_back(refl);
 					}
 			} else if (m_type==DMR) {
 				char* p1 = ::strtok(buffer, ";\r\n");
@@ -181,7 +358,7 @@ bool CReflectors::load()
 					refl->m_opt 	= atoi(p2);
 					refl->m_name.resize(16U, ' ');
 					refl->m_desc.resize(14U, ' ');
-					m_newReflectors.push_back(refl);
+					reflectors.push_back(refl);
 					}
 			}	else if (m_type==DMRP) {
 				char* p1 = ::strtok(buffer, ";\r\n");
@@ -201,17 +378,158 @@ bool CReflectors::load()
 					refl->m_opt 	= 1;
 					refl->m_name.resize(16U, ' ');
 					refl->m_desc.resize(14U, ' ');
-					m_newReflectors.push_back(refl);
+					reflectors.push_back(refl);
 					}
 			}
 		}
 
 		::fclose(fp);
 	}
+}
+
+bool CReflectors::readCache(std::vector<CReflector*>& reflectors)
+{
+	CBinaryCache cache;
+	if (!cache.open(m_cacheFile, CACHE_MAGIC, CACHE_VERSION, m_type, m_hostsFile))
+		return false;
+
+	const CCacheHeader* header = cache.header();
+
+	size_t records = header->m_count * sizeof(CReflectorRecord);
+	if (header->m_poolSize == 0U || cache.length() != records + header->m_poolSize) {
+		LogWarning("Ignoring the damaged reflector cache - %s", m_cacheFile.c_str());
+		return false;
+	}
+
+	const CReflectorRecord* record = (const CReflectorRecord*)cache.data();
+	const char* pool = (const char*)(cache.data() + records);
+
+	// Every string ends inside the pool
+	if (pool[header->m_poolSize - 1U] != 0x00) {
+		LogWarning("Ignoring the damaged reflector cache - %s", m_cacheFile.c_str());
+		return false;
+	}
+
+	reflectors.reserve(header->m_count);
+
+	for (unsigned int i = 0U; i < header->m_count; i++, record++) {
+		if (record->m_id >= header->m_poolSize || record->m_name >= header->m_poolSize || record->m_desc >= header->m_poolSize ||
+			record->m_count >= header->m_poolSize || record->m_host >= header->m_poolSize) {
+			LogWarning("Ignoring the damaged reflector cache - %s", m_cacheFile.c_str());
+			for (std::vector<CReflector*>::iterator it = reflectors.begin(); it != reflectors.end(); ++it)
+				delete *it;
+			reflectors.clear();
+			return false;
+		}
+
+		CReflector* refl = new CReflector;
+		refl->m_id    = std::string(pool + record->m_id);
+		refl->m_name  = std::string(pool + record->m_name);
+		refl->m_desc  = std::string(pool + record->m_desc);
+		refl->m_count = std::string(pool + record->m_count);
+		refl->m_host  = std::string(pool + record->m_host);
+		refl->m_port  = record->m_port;
+		refl->m_type  = TG_TYPE(record->m_type);
+		refl->m_opt   = record->m_opt;
+		reflectors.push_back(refl);
+	}
+
+	return true;
+}
+
+void CReflectors::writeCache(CCacheHeader& header, const std::vector<CReflector*>& reflectors)
+{
+	std::vector<CReflectorRecord> records;
+	records.reserve(reflectors.size());
+
+	std::string pool;
+
+	for (std::vector<CReflector*>::const_iterator it = reflectors.begin(); it != reflectors.end(); ++it) {
+		const CReflector* refl = *it;
+
+		CReflectorRecord record;
+		record.m_id    = pool.size();
+		pool.append(refl->m_id.c_str(), refl->m_id.size() + 1U);
+		record.m_name  = pool.size();
+		pool.append(refl->m_name.c_str(), refl->m_name.size() + 1U);
+		record.m_desc  = pool.size();
+		pool.append(refl->m_desc.c_str(), refl->m_desc.size() + 1U);
+		record.m_count = pool.size();
+		pool.append(refl->m_count.c_str(), refl->m_count.size() + 1U);
+		record.m_host  = pool.size();
+		pool.append(refl->m_host.c_str(), refl->m_host.size() + 1U);
+		record.m_port  = refl->m_port;
+		record.m_type  = refl->m_type;
+		record.m_opt   = refl->m_opt;
+		records.push_back(record);
+	}
+
+	header.m_count    = records.size();
+	header.m_poolSize = pool.size();
+
+	std::vector<CCacheBlock> blocks;
+
+	CCacheBlock block;
+	block.m_data   = records.data();
+	block.m_length = records.size() * sizeof(CReflectorRecord);
+	blocks.push_back(block);
+
+	block.m_data   = pool.data();
+	block.m_length = pool.size();
+	blocks.push_back(block);
+
+	CBinaryCache::write(m_cacheFile, header, blocks);
+}
+
+// Runs on either thread, so only reads what is set before read()
+CReflectorList* CReflectors::parse()
+{
+	std::vector<CReflector*> entries;
+
+	if (m_cacheFile.empty() || !readCache(entries)) {
+		// Taken first, so that a change while the file is read makes the cache stale
+		CCacheHeader header;
+		bool cache = !m_cacheFile.empty() && CBinaryCache::header(header, CACHE_MAGIC, CACHE_VERSION, m_type, m_hostsFile);
+
+		readText(entries);
+
+		if (cache && !entries.empty())
+			writeCache(header, entries);
+	}
+
+	CReflectorList* reflectors = new CReflectorList;
+
+	std::vector<std::string> hosts;
+
+	for (std::vector<CReflector*>::iterator it = entries.begin(); it != entries.end(); ++it) {
+		CReflector* refl = *it;
 
-	size_t size = m_newReflectors.size();
+		if (!refl->m_host.empty()) {
+			if (m_resolver == NULL) {
+				refl->m_address = CUDPSocket::lookup(refl->m_host);
+				if (refl->m_address.s_addr == INADDR_NONE) {
+					delete refl;
+					continue;
+				}
+			} else {
+				// A cached address will do until the lookup refreshes it
+				if (!m_resolver->find(refl->m_host, refl->m_address))
+					refl->m_address.s_addr = INADDR_NONE;
+				hosts.push_back(refl->m_host);
+			}
+		}
+
+		reflectors->add(refl);
+	}
+
+	size_t size = reflectors->m_reflectors.size();
 	LogInfo("Loaded %u %s reflectors", size, m_type_str.c_str());
 
+	if (!hosts.empty()) {
+		LogInfo("Resolving %u %s reflector hosts in the background", hosts.size(), m_type_str.c_str());
+		m_resolver->prefetch(hosts, RESOLVE_TIMEOUT);
+	}
+
 	// Add the Parrot entry
 	if (m_parrotAddress != NULL) {
 		//LogInfo("Parrot Entry");
@@ -227,46 +545,43 @@ bool CReflectors::load()
 		refl->m_type    = YSF;
 		refl->m_opt 	= 0;
 
-		m_newReflectors.push_back(refl);
+		reflectors->add(refl);
 
 	//	LogInfo("Loaded YSF parrot");
 	}
 
-	size = m_newReflectors.size();
-	if (size == 0U)
-		return false;
+	if (reflectors->m_reflectors.empty()) {
+		delete reflectors;
+		return NULL;
+	}
 
 	if (m_makeUpper) {
-		for (std::vector<CReflector*>::iterator it = m_newReflectors.begin(); it != m_newReflectors.end(); ++it) {
+		for (std::vector<CReflector*>::iterator it = reflectors->m_reflectors.begin(); it != reflectors->m_reflectors.end(); ++it) {
 			std::transform((*it)->m_name.begin(), (*it)->m_name.end(), (*it)->m_name.begin(), ::toupper);
 			std::transform((*it)->m_desc.begin(), (*it)->m_desc.end(), (*it)->m_desc.begin(), ::toupper);
 		}
 	}
 
-	std::sort(m_newReflectors.begin(), m_newReflectors.end(), refComparison);
+	reflectors->index();
 
-	for (std::vector<CReflector*>::iterator it = m_currReflectors.begin(); it != m_currReflectors.end(); ++it)
-		delete *it;
+	return reflectors;
+}
 
-	m_currReflectors.clear();
+void CReflectors::use(CReflectorList* reflectors)
+{
+	assert(reflectors != NULL);
 
-	m_currReflectors = m_newReflectors;
+	delete m_currReflectors;
+	m_currReflectors = reflectors;
 
-	m_newReflectors.clear();
-	return true;
+	m_search.clear();
 }
 
 CReflector* CReflectors::findById(const std::string& id)
 {
-
-//	LogMessage("Looking for reflector %s",id.c_str());
-
-	for (std::vector<CReflector*>::const_iterator it = m_currReflectors.cbegin(); it != m_currReflectors.cend(); ++it) {
-		if (id == (*it)->m_id) {
-		//	LogMessage("Found reflector %s : %s",id.c_str(),(*it)->m_name.c_str());
-			return *it;
-		}			
-	}
+	CReflector* reflector = m_currReflectors->findById(id);
+	if (reflector != NULL)
+		return reflector;
 
 	LogMessage("Trying to find non existent %s reflector with an id of %s", m_type_str.c_str(), id.c_str());
 
@@ -281,10 +596,9 @@ CReflector* CReflectors::findByName(const std::string& name)
         }
 	fullName.resize(16U, ' ');
 
-	for (std::vector<CReflector*>::const_iterator it = m_currReflectors.cbegin(); it != m_currReflectors.cend(); ++it) {
-		if (fullName == (*it)->m_name)
-			return *it;
-	}
+	CReflector* reflector = m_currReflectors->findByName(fullName);
+	if (reflector != NULL)
+		return reflector;
 
 	LogMessage("Trying to find non existent %s reflector with a name of %s", m_type_str.c_str(), name.c_str());
 
@@ -293,78 +607,49 @@ CReflector* CReflectors::findByName(const std::string& name)
 
 std::vector<CReflector*>& CReflectors::current()
 {
-	return m_currReflectors;
+	return m_currReflectors->m_reflectors;
 }
 
 std::vector<CReflector*>& CReflectors::search(const std::string& name)
 {
-	m_search.clear();
-
-	std::string trimmed = name;
-	trimmed.erase(std::find_if(trimmed.rbegin(), trimmed.rend(), std::not1(std::ptr_fun<int, int>(std::isspace))).base(), trimmed.end());
-	std::transform(trimmed.begin(), trimmed.end(), trimmed.begin(), ::toupper);
-
-	// Removed now un-used variable
-	// size_t len = trimmed.size();
-
-	for (std::vector<CReflector*>::iterator it = m_currReflectors.begin(); it != m_currReflectors.end(); ++it) {
-		std::string reflector = (*it)->m_name;
-		reflector.erase(std::find_if(reflector.rbegin(), reflector.rend(), std::not1(std::ptr_fun<int, int>(std::isspace))).base(), reflector.end());
-		std::transform(reflector.begin(), reflector.end(), reflector.begin(), ::toupper);
-
-		// Origional match function - only matches start of string.
-		// if (trimmed == reflector.substr(0U, len))
-		//	m_search.push_back(*it);
-		
-		// New match function searches the whole string
-		unsigned int refSrcPos;
-                for (refSrcPos=0;refSrcPos<reflector.length(); refSrcPos++)
-                {
-                        if (reflector.substr(refSrcPos,trimmed.length()) == trimmed)
-                        {
-                                m_search.push_back(*it);
-                        }
-                }
-	}
-
-	std::sort(m_search.begin(), m_search.end(), refComparison);
+	m_currReflectors->search(searchKey(name), m_search);
 
 	return m_search;
 }
 
-bool CReflectors::reload()
+void CReflectors::setParrot(in_addr *address, unsigned int port)
 {
-	if (m_newReflectors.empty())
-		return false;
-	load();
-
-	for (std::vector<CReflector*>::iterator it = m_currReflectors.begin(); it != m_currReflectors.end(); ++it)
-		delete *it;
-
-	m_currReflectors.clear();
+	m_parrotAddress = address;
+	m_parrotPort    = port;
+}
 
-	m_currReflectors = m_newReflectors;
+void CReflectors::setResolver(CHostResolver* resolver)
+{
+	m_resolver = resolver;
+}
 
+RESOLVE_STATUS CReflectors::resolve(CReflector* reflector)
+{
+	assert(reflector != NULL);
 
+	if (m_resolver == NULL || reflector->m_host.empty())
+		return reflector->m_address.s_addr != INADDR_NONE ? RESOLVE_FOUND : RESOLVE_FAILED;
 
-//	m_newReflectors.clear();
+	// The latest lookup since the list was loaded, or one started now
+	in_addr address;
+	RESOLVE_STATUS status = m_resolver->resolve(reflector->m_host, address);
+	if (status == RESOLVE_PENDING)
+		return status;
 
-	return true;
-}
+	if (status == RESOLVE_FOUND)
+		reflector->m_address = address;
 
-void CReflectors::setParrot(in_addr *address, unsigned int port)
-{
-	m_parrotAddress = address;
-	m_parrotPort    = port;
+	return reflector->m_address.s_addr != INADDR_NONE ? RESOLVE_FOUND : RESOLVE_FAILED;
 }
 
-void CReflectors::clock(unsigned int ms)
+void CReflectors::clock()
 {
-	m_timer.clock(ms);
-
-	if (m_timer.isRunning() && m_timer.hasExpired()) {
-		load();
-//		reload();
-		m_timer.start();
-	}
+	CReflectorList* reflectors = m_newReflectors.exchange(NULL);
+	if (reflectors != NULL)
+		use(reflectors);
 }
@@ -19,8 +19,13 @@
 #if !defined(Reflectors_H)
 #define	Reflectors_H
 
+#include "HostResolver.h"
+#include "BinaryCache.h"
 #include "UDPSocket.h"
+#include "Thread.h"
 #include "Timer.h"
+#include <atomic>
+#include <unordered_map>
 #include <vector>
 #include <string>
 
@@ -42,6 +47,7 @@ public:
 	m_desc(),
 	m_count("000"),
 	m_address(),
+	m_host(),
 	m_port(0U),
 	m_type(NONE)
 	{
@@ -52,18 +58,64 @@ public:
 	std::string  m_desc;
 	std::string  m_count;	
 	in_addr      m_address;
+	std::string  m_host;
 	unsigned int m_port;
 	TG_TYPE 	 m_type;
 	unsigned int m_opt;	
 };
 
-class CReflectors {
+// A sorted list of reflectors and the indexes the lookups use, built in one
+// go and not changed after that. Search looks for a piece of the name, so
+// every one, two and three character piece of each upper cased name has the
+// positions of the reflectors with that piece in their name, in list order.
+class CReflectorList {
+public:
+	CReflectorList();
+	~CReflectorList();
+
+	// Takes ownership of the reflector
+	void add(CReflector* reflector);
+
+	// Sorts the list and builds the indexes, after the last add()
+	void index();
+
+	CReflector* findById(const std::string& id) const;
+	CReflector* findByName(const std::string& name) const;
+
+	// The text must be trimmed and upper cased
+	void search(const std::string& text, std::vector<CReflector*>& found) const;
+
+	std::vector<CReflector*>                                     m_reflectors;
+
+private:
+	std::unordered_map<std::string, CReflector*>                 m_ids;
+	std::unordered_map<std::string, CReflector*>                 m_names;
+	std::vector<std::string>                                     m_keys;
+	std::unordered_map<unsigned int, std::vector<unsigned int> > m_pieces;
+
+	CReflectorList(const CReflectorList&);
+	CReflectorList& operator=(const CReflectorList&);
+};
+
+// The list is read once by read() and then again every reload time by a
+// thread of its own, which builds the new list away from the gateway's main
+// thread and hands it over with an atomic exchange. Only clock() puts it in
+// use, so every other call is made on the main thread against a list that
+// does not change under it.
+class CReflectors : public CThread {
 public:
 	CReflectors(const std::string& hostsFile, TG_TYPE type, unsigned int reloadTime, bool makeUpper);
-	~CReflectors();
+	virtual ~CReflectors();
+
+	// A directory for the binary copy of the list, to be set before read()
+	void setCachePath(const std::string& path);
+
+	bool read();
 
 	bool load();
 
+	virtual void entry();
+
 	CReflector* findById(const std::string& id);
 	CReflector* findByName(const std::string& name);
 
@@ -71,22 +123,36 @@ public:
 
 	std::vector<CReflector*>& search(const std::string& name);
 
-	bool reload();
-
-	void clock(unsigned int ms);
+	void clock();
 	void setParrot(in_addr *address, unsigned int port);
 
+	// YSF reflectors are loaded before their hosts are resolved, when there is
+	// a resolver, and must be resolved before their address is used. That
+	// never blocks, the lookup is RESOLVE_PENDING until the resolver has it.
+	void setResolver(CHostResolver* resolver);
+	RESOLVE_STATUS resolve(CReflector* reflector);
+
 private:
-	std::string                 m_hostsFile;
-	std::vector<CReflector*> 	m_newReflectors;
-	std::vector<CReflector*> 	m_currReflectors;
-	std::vector<CReflector*> 	m_search;
-	bool                        m_makeUpper;
-	CTimer                      m_timer;
-	TG_TYPE      			    m_type;
-	std::string					m_type_str;
-	in_addr  					*m_parrotAddress;
-	unsigned int 				m_parrotPort;	
+	std::string                            m_hostsFile;
+	std::string                            m_cacheFile;
+	std::atomic<CReflectorList*>           m_newReflectors;
+	CReflectorList*                        m_currReflectors;
+	std::vector<CReflector*>               m_search;
+	bool                                   m_makeUpper;
+	unsigned int                           m_reloadTime;
+	TG_TYPE                                m_type;
+	std::string                            m_type_str;
+	in_addr*                               m_parrotAddress;
+	unsigned int                           m_parrotPort;
+	CHostResolver*                         m_resolver;
+	bool                                   m_running;
+	std::atomic<bool>                      m_stop;
+
+	CReflectorList* parse();
+	void readText(std::vector<CReflector*>& reflectors);
+	bool readCache(std::vector<CReflector*>& reflectors);
+	void writeCache(CCacheHeader& header, const std::vector<CReflector*>& reflectors);
+	void use(CReflectorList* reflectors);
 };
 
 #endif
@@ -25,18 +25,24 @@
 #include <cassert>
 #include <cstring>
 
+// T is copied with memcpy, so it must be a plain type. When the length is a
+// power of two the pointers wrap with a mask rather than a compare.
 template<class T> class CRingBuffer {
 public:
 	CRingBuffer(unsigned int length, const char* name) :
 	m_length(length),
 	m_name(name),
 	m_buffer(NULL),
+	m_mask(0U),
 	m_iPtr(0U),
 	m_oPtr(0U)
 	{
 		assert(length > 0U);
 		assert(name != NULL);
 
+		if ((length & (length - 1U)) == 0U)
+			m_mask = length - 1U;
+
 		m_buffer = new T[length];
 
 		::memset(m_buffer, 0x00, m_length * sizeof(T));
@@ -54,12 +60,14 @@ public:
 			return false;
 		}
 
-		for (unsigned int i = 0U; i < nSamples; i++) {
-			m_buffer[m_iPtr++] = buffer[i];
+		unsigned int first = m_length - m_iPtr;
+		if (first > nSamples)
+			first = nSamples;
 
-			if (m_iPtr == m_length)
-				m_iPtr = 0U;
-		}
+		::memcpy(m_buffer + m_iPtr, buffer, first * sizeof(T));
+		::memcpy(m_buffer, buffer + first, (nSamples - first) * sizeof(T));
+
+		m_iPtr = advance(m_iPtr, nSamples);
 
 		return true;
 	}
@@ -71,12 +79,9 @@ public:
 			return false;
 		}
 
-		for (unsigned int i = 0U; i < nSamples; i++) {
-			buffer[i] = m_buffer[m_oPtr++];
+		copyOut(buffer, nSamples);
 
-			if (m_oPtr == m_length)
-				m_oPtr = 0U;
-		}
+		m_oPtr = advance(m_oPtr, nSamples);
 
 		return true;
 	}
@@ -88,17 +93,50 @@ public:
 			return false;
 		}
 
-		unsigned int ptr = m_oPtr;
-		for (unsigned int i = 0U; i < nSamples; i++) {
-			buffer[i] = m_buffer[ptr++];
-
-			if (ptr == m_length)
-				ptr = 0U;
-		}
+		copyOut(buffer, nSamples);
 
 		return true;
 	}
 
+	// The free space that follows on from the write pointer without wrapping,
+	// for a producer to fill in place before calling commit()
+	T* writeSpan(unsigned int& nSamples)
+	{
+		// One slot is always left empty, so that full and empty differ
+		nSamples = freeSpace() - 1U;
+
+		if (nSamples > (m_length - m_iPtr))
+			nSamples = m_length - m_iPtr;
+
+		return m_buffer + m_iPtr;
+	}
+
+	void commit(unsigned int nSamples)
+	{
+		assert(nSamples < freeSpace());
+
+		m_iPtr = advance(m_iPtr, nSamples);
+	}
+
+	// The data that follows on from the read pointer without wrapping, for a
+	// consumer to use in place before calling consume()
+	const T* readSpan(unsigned int& nSamples) const
+	{
+		nSamples = dataSize();
+
+		if (nSamples > (m_length - m_oPtr))
+			nSamples = m_length - m_oPtr;
+
+		return m_buffer + m_oPtr;
+	}
+
+	void consume(unsigned int nSamples)
+	{
+		assert(nSamples <= dataSize());
+
+		m_oPtr = advance(m_oPtr, nSamples);
+	}
+
 	void clear()
 	{
 		m_iPtr = 0U;
@@ -142,8 +180,31 @@ private:
 	unsigned int m_length;
 	const char*  m_name;
 	T*           m_buffer;
+	unsigned int m_mask;
 	unsigned int m_iPtr;
 	unsigned int m_oPtr;
+
+	void copyOut(T* buffer, unsigned int nSamples) const
+	{
+		unsigned int first = m_length - m_oPtr;
+		if (first > nSamples)
+			first = nSamples;
+
+		::memcpy(buffer, m_buffer + m_oPtr, first * sizeof(T));
+		::memcpy(buffer + first, m_buffer, (nSamples - first) * sizeof(T));
+	}
+
+	unsigned int advance(unsigned int ptr, unsigned int nSamples) const
+	{
+		if (m_mask != 0U)
+			return (ptr + nSamples) & m_mask;
+
+		ptr += nSamples;
+		if (ptr >= m_length)
+			ptr -= m_length;
+
+		return ptr;
+	}
 };
 
 #endif
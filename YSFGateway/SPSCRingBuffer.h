@@ -0,0 +1,190 @@
+/*
+ *   Copyright (C) 2026 by agent
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef SPSCRingBuffer_H
+#define SPSCRingBuffer_H
+
+#include "Log.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+
+const unsigned int SPSC_CACHE_LINE = 64U;
+
+// A ring buffer that one thread may add to while one other thread takes from
+// it, without a lock. The producer publishes what it has written with a
+// release store of its index and the consumer picks it up with an acquire
+// load, and the same the other way for the space freed. Each side keeps a
+// copy of the other's index and only reloads it when that copy says the
+// buffer is full or empty. The two indexes are a cache line apart so that
+// the threads do not contend for one line.
+//
+// The length is rounded up to a power of two and all of it can be used. T is
+// copied with memcpy, so it must be a plain type.
+template<class T> class CSPSCRingBuffer {
+public:
+	CSPSCRingBuffer(unsigned int length, const char* name) :
+	m_name(name),
+	m_buffer(NULL),
+	m_length(1U),
+	m_mask(0U),
+	m_head(0U),
+	m_tailCache(0U),
+	m_tail(0U),
+	m_headCache(0U)
+	{
+		assert(length > 0U);
+		assert(name != NULL);
+
+		while (m_length < length)
+			m_length <<= 1;
+
+		m_mask = m_length - 1U;
+
+		m_buffer = new T[m_length];
+
+		::memset(m_buffer, 0x00, m_length * sizeof(T));
+	}
+
+	~CSPSCRingBuffer()
+	{
+		delete[] m_buffer;
+	}
+
+	// Producer only
+	bool push(const T& item)
+	{
+		return push(&item, 1U) == 1U;
+	}
+
+	// Producer only, adds as many as there is room for and returns how many
+	unsigned int push(const T* items, unsigned int nItems)
+	{
+		assert(items != NULL);
+
+		unsigned int head = m_head.load(std::memory_order_relaxed);
+
+		if ((m_length - (head - m_tailCache)) < nItems)
+			m_tailCache = m_tail.load(std::memory_order_acquire);
+
+		unsigned int space = m_length - (head - m_tailCache);
+		if (nItems > space) {
+			LogError("**** Overflow in %s ring buffer, %u > %u", m_name, nItems, space);
+			nItems = space;
+		}
+
+		if (nItems == 0U)
+			return 0U;
+
+		unsigned int ptr   = head & m_mask;
+		unsigned int first = m_length - ptr;
+		if (first > nItems)
+			first = nItems;
+
+		::memcpy(m_buffer + ptr, items, first * sizeof(T));
+		::memcpy(m_buffer, items + first, (nItems - first) * sizeof(T));
+
+		m_head.store(head + nItems, std::memory_order_release);
+
+		return nItems;
+	}
+
+	// Consumer only
+	bool pop(T& item)
+	{
+		return pop(&item, 1U) == 1U;
+	}
+
+	// Consumer only, takes up to nItems and returns how many
+	unsigned int pop(T* items, unsigned int nItems)
+	{
+		assert(items != NULL);
+
+		unsigned int tail = m_tail.load(std::memory_order_relaxed);
+
+		if ((m_headCache - tail) < nItems)
+			m_headCache = m_head.load(std::memory_order_acquire);
+
+		unsigned int available = m_headCache - tail;
+		if (nItems > available)
+			nItems = available;
+
+		// Storing the unchanged index would still take the line from the producer
+		if (nItems == 0U)
+			return 0U;
+
+		unsigned int ptr   = tail & m_mask;
+		unsigned int first = m_length - ptr;
+		if (first > nItems)
+			first = nItems;
+
+		::memcpy(items, m_buffer + ptr, first * sizeof(T));
+		::memcpy(items + first, m_buffer, (nItems - first) * sizeof(T));
+
+		m_tail.store(tail + nItems, std::memory_order_release);
+
+		return nItems;
+	}
+
+	// Either side may ask, but the answer may be out of date by the time it is used
+	unsigned int dataSize() const
+	{
+		unsigned int tail = m_tail.load(std::memory_order_acquire);
+		unsigned int head = m_head.load(std::memory_order_acquire);
+
+		return head - tail;
+	}
+
+	unsigned int freeSpace() const
+	{
+		return m_length - dataSize();
+	}
+
+	bool isEmpty() const
+	{
+		return dataSize() == 0U;
+	}
+
+	unsigned int length() const
+	{
+		return m_length;
+	}
+
+private:
+	const char*               m_name;
+	T*                        m_buffer;
+	unsigned int              m_length;
+	unsigned int              m_mask;
+	char                      m_pad1[SPSC_CACHE_LINE];
+
+	// Written by the producer
+	std::atomic<unsigned int> m_head;
+	unsigned int              m_tailCache;
+	char                      m_pad2[SPSC_CACHE_LINE];
+
+	// Written by the consumer
+	std::atomic<unsigned int> m_tail;
+	unsigned int              m_headCache;
+	char                      m_pad3[SPSC_CACHE_LINE];
+
+	CSPSCRingBuffer(const CSPSCRingBuffer&);
+	CSPSCRingBuffer& operator=(const CSPSCRingBuffer&);
+};
+
+#endif
@@ -33,6 +33,9 @@ public:
 
 	unsigned long long time() const;
 
+	// A monotonic time in microseconds, for measuring short intervals
+	unsigned long long micros() const;
+
 	unsigned long long start();
 	unsigned int       elapsed();
 
@@ -57,6 +57,13 @@ m_beacon(false),
 m_beacon_name("/usr/local/sbin/beacon.amb"),
 
 m_conv(),
+m_fich(),
+m_payload(),
+m_fichStats(),
+m_metrics(),
+m_metricsEnabled(false),
+m_metricsFile(),
+m_metricsTimer(1000U),
 
 m_modemNetwork(NULL),
 m_ysfNetwork(NULL),
@@ -101,11 +108,21 @@ m_jitter_timer(NULL)
 	m_dstid 	= 		atoi(m_conf->getNetworkStartup().c_str());
 	
 	LogInfo("    AMBE Recording: %s", m_saveAMBE ? "yes" : "no");   
+
+	m_metricsEnabled = m_conf->getMetricsEnabled();
+	m_metricsFile    = m_conf->getMetricsFile();
+	if (m_metricsEnabled) {
+		unsigned int interval = m_conf->getMetricsInterval();
+		m_metricsTimer.start(interval > 0U ? interval : 1U);
+		LogInfo("    Metrics: %s every %us", m_metricsFile.c_str(), interval > 0U ? interval : 1U);
+	}
+
 	m_real_rcv_callsign ="";
 	m_real_rcv_callsign.resize(YSF_CALLSIGN_LENGTH,' ');
 	std::string lookupFile = m_conf->getDMRIdLookupFile();
 	if (lookupFile.empty()) lookupFile  = "/usr/local/etc/DMRIds.dat";
 	m_lookup = new CDMRLookup(lookupFile,m_conf->getNetworkReloadTime());
+	m_lookup->setCachePath(m_conf->getNetworkCachePath());
 	m_lookup->read();	
 	m_rcv_callsign = m_real_rcv_callsign;
 }
@@ -427,6 +444,22 @@ void CStreamer::clock(TG_STATUS m_TG_connect_state, unsigned int ms) {
 
     	if (m_writer != NULL)
 			m_writer->clock(ms);
+
+		if (m_metricsEnabled) {
+			m_metricsTimer.clock(ms);
+			if (m_metricsTimer.hasExpired()) {
+				if (m_modemNetwork != NULL)
+					m_metrics.setBudgetHits(RECEIVE_MODEM, m_modemNetwork->getBudgetHits());
+				if (m_ysfNetwork != NULL)
+					m_metrics.setBudgetHits(RECEIVE_YSF, m_ysfNetwork->getBudgetHits());
+				if (m_fcsNetwork != NULL)
+					m_metrics.setBudgetHits(RECEIVE_FCS, m_fcsNetwork->getBudgetHits());
+				if (m_dmrNetwork != NULL)
+					m_metrics.setBudgetHits(RECEIVE_DMR, m_dmrNetwork->getBudgetHits());
+				m_metrics.write(m_metricsFile);
+				m_metricsTimer.start();
+			}
+		}
 		
 		m_wiresX->clock(ms);   
 
@@ -507,18 +540,20 @@ void CStreamer::AMBE_write(unsigned char* buffer, unsigned char fi, unsigned cha
 	static int ysfFrames;
 				
 	if ((::memcmp(buffer, "YSFD", 4U) == 0U) && (dt == YSF_DT_VD_MODE2)) {
-		CYSFPayload ysfPayload;
 
 		if (fi == YSF_FI_HEADER) {
-			if (ysfPayload.processHeaderData(buffer + 35U)) {
+			// processHeaderData() keeps any callsigns it already has
+			m_payload.reset();
+
+			if (m_payload.processHeaderData(buffer + 35U)) {
 				sprintf(tmp, "/tmp/file%03d.amb",count_file_AMBE);
 				count_file_AMBE++;
 				file = fopen(tmp,"wb");
 				if (!file) LogMessage("Error creating AMBE file: %s",tmp);
 				else LogMessage("Recording AMBE file: %s",tmp);
 
-				std::string ysfSrc = ysfPayload.getSource();
-				std::string ysfDst = ysfPayload.getDest();
+				std::string ysfSrc = m_payload.getSource();
+				std::string ysfDst = m_payload.getDest();
 				LogMessage("Writing AMBE from YSF Header: Src: %s Dst: %s", ysfSrc.c_str(), ysfDst.c_str());
 				m_conv.putYSFHeader();
 				ysfFrames = 0U;				
@@ -548,15 +583,17 @@ WX_STATUS ret;
 	
 	while ((len=rptNetwork->read(recv_buffer)) > 0U) {			
 		if (::memcmp(recv_buffer, "YSFD", 4U) != 0U) continue;
-		CYSFFICH fich;
-		bool valid = fich.decode(recv_buffer + 35U);
+		bool valid = m_fich.decode(recv_buffer + 35U);
+		// Only logged, and reset, at the end of a transmission sent to DMR
+		if (m_tg_type == DMR)
+			m_fichStats.add(YSF_FICH_CODED_BITS, m_fich.getErrors(), valid ? 0U : 1U);
 		if (valid) {
-			unsigned char fi = fich.getFI();
-			unsigned char dt = fich.getDT();
-			unsigned char fn = fich.getFN();
-			unsigned char ft = fich.getFT();
-			unsigned char bn = fich.getBN();
-			unsigned char bt = fich.getBT();
+			unsigned char fi = m_fich.getFI();
+			unsigned char dt = m_fich.getDT();
+			unsigned char fn = m_fich.getFN();
+			unsigned char ft = m_fich.getFT();
+			unsigned char bn = m_fich.getBN();
+			unsigned char bt = m_fich.getBT();
 
 			if (m_TG_connect_state != TG_DISABLE) {
 				if (fi == YSF_FI_HEADER) m_not_busy=false;
@@ -610,8 +647,8 @@ WX_STATUS ret;
 				// }			
 				
 				if (m_NoChange) {
-					fich.setDGId(m_DGID);
-					fich.encode(recv_buffer + 35U);
+					m_fich.setDGId(m_DGID);
+					m_fich.encode(recv_buffer + 35U);
 				}
 
 				if (m_saveAMBE) 
@@ -778,7 +815,6 @@ static unsigned char tmp[20];
 static unsigned char dch[20U];
 static bool first_time,beacon_running;
 std::string tmp_str;
-CYSFPayload ysfPayload;
 	
 	// Only pass through YSF data packets
 	if ((::memcmp(buffer + 0U, "YSFD", 4U) == 0) && !m_wiresX->isBusy()) {
@@ -791,17 +827,16 @@ CYSFPayload ysfPayload;
 			beacon_running = true;
 		} else beacon_running = false;
 	
-		CYSFFICH fich;
-		bool valid = fich.decode(buffer + 35U);
+		bool valid = m_fich.decode(buffer + 35U);
 
 		unsigned int connections=0;
 		unsigned int id;	
 		
 		if (valid) {
-			unsigned char fi = fich.getFI();
-			unsigned char dt = fich.getDT();
-			unsigned char fn = fich.getFN();
-			unsigned char ft = fich.getFT();  // ft=6 no gps  ft=7 gps
+			unsigned char fi = m_fich.getFI();
+			unsigned char dt = m_fich.getDT();
+			unsigned char fn = m_fich.getFN();
+			unsigned char ft = m_fich.getFT();  // ft=6 no gps  ft=7 gps
 
 	
 			if ((m_tg_type == YSF) && (ft==fn) && (m_ysfNetwork->getRoomInfo(id,connections,tmp_str))) { 
@@ -837,7 +872,7 @@ CYSFPayload ysfPayload;
 			if (dt==YSF_DT_VD_MODE1) {	
 				if (fi==YSF_FI_HEADER) {					
 					m_rcv_callsign = getSrcYSF_fromHeader(buffer);
-					m_gid = fich.getDGId();					
+					m_gid = m_fich.getDGId();					
 					LogMessage("Received Voice Data Mode 1 *%s* from *%s*, gid=%d.",m_rcv_callsign.c_str(),m_netDst.c_str(),m_gid);
 					m_conv.putDMRHeaderV1();
 					first_time = true;
@@ -850,14 +885,14 @@ CYSFPayload ysfPayload;
 							LogMessage("");
 						} else {
 							m_rcv_callsign = getSrcYSF_fromData(buffer);
-							m_gid = fich.getDGId();
+							m_gid = m_fich.getDGId();
 							LogMessage("Voice Data Mode 1 Late Entry from %s, gid=%d.",m_rcv_callsign.c_str(),m_gid);
 							m_conv.putDMRHeaderV1();
 							first_time = true;
 							m_open_channel = true;
 						}						
 					}
-					ysfPayload.readVDMode1Data(buffer + 35U, dch); 
+					m_payload.readVDMode1Data(buffer + 35U, dch); 
 					m_conv.putVCHV1(buffer + 35U);
 					m_conv.putDCHV1(dch);
 				} else if (fi==YSF_FI_TERMINATOR) {
@@ -875,7 +910,6 @@ CYSFPayload ysfPayload;
 				m_open_channel = true;
 			} else if (dt==YSF_DT_VD_MODE2) {
 				if (fi==YSF_FI_HEADER) {
-					CYSFPayload payload;
 					
 					if (m_open_channel && (!beacon_running)) {
 						tmp_str = getSrcYSF_fromHeader(buffer);
@@ -890,7 +924,7 @@ CYSFPayload ysfPayload;
 						}
 					} else strcpy(alien_user,"");
 
-					if (payload.readVDMode1Data(buffer+35U,dch) && dch[5U]!='*') memcpy(ysf_radioid,dch+5U,5U);
+					if (m_payload.readVDMode1Data(buffer+35U,dch) && dch[5U]!='*') memcpy(ysf_radioid,dch+5U,5U);
 					else memcpy(ysf_radioid,std_ysf_radioid,5U);
 					// memcpy(tmp,ysf_radioid,5U);
 					// tmp[5U]=0;
@@ -899,7 +933,7 @@ CYSFPayload ysfPayload;
 					//m_gid = fich.getDGId();					
 					LogMessage("Received voice data *%s* from *%s*, gid=%d, rid=%5.5s.",m_rcv_callsign.c_str(),m_netDst.c_str(),m_gid,ysf_radioid);
 					if (m_APRS != NULL) m_APRS->get_gps_buffer(m_gps_buffer,m_rcv_callsign);
-					m_gid = fich.getDGId();
+					m_gid = m_fich.getDGId();
 					m_conv.putDMRHeader();
 					first_time = true;
 					if (m_jitter_timer) m_jitter_timer->start();
@@ -914,7 +948,7 @@ CYSFPayload ysfPayload;
 							if (m_tg_type == FCS) { if (fn==1) m_rcv_callsign=getSrcYSF_fromFN1(buffer);}
 							else m_rcv_callsign = getSrcYSF_fromData(buffer);
 							if (m_APRS != NULL) m_APRS->get_gps_buffer(m_gps_buffer,m_rcv_callsign);
-							m_gid = fich.getDGId();
+							m_gid = m_fich.getDGId();
 							LogMessage("Late Entry from %s, gid=%d.",m_rcv_callsign.c_str(),m_gid);
 							memcpy(ysf_radioid,std_ysf_radioid,5U);
 							strcpy(alien_user,"");
@@ -943,7 +977,7 @@ CYSFPayload ysfPayload;
 					if ((ft==6) && (fn==6)) {
 						//show info once
 						if (first_time) {
-							ysfPayload.readVDMode2Data(buffer + 35U, tmp);
+							m_payload.readVDMode2Data(buffer + 35U, tmp);
 							CUtils::dump("GPS Info not provided",tmp,10U);
 							LogMessage("Radio: %s.",get_radio(*(tmp+4)));						
 							first_time = false;
@@ -954,7 +988,7 @@ CYSFPayload ysfPayload;
 					// Update gps info for ft=7
 					if ((ft==7) && ((fn==6) || (fn==7))) {
 						if (fn==6) {
-							ysfPayload.readVDMode2Data(buffer + 35U, tmp);
+							m_payload.readVDMode2Data(buffer + 35U, tmp);
 							if ((*(tmp + 5U) == 0x00) && (*(tmp + 2U) == 0x62)) {
 								if (first_time) {
 									LogMessage("GPS Info Empty. DMR Transcoding?");
@@ -972,7 +1006,7 @@ CYSFPayload ysfPayload;
 						} else {
 							if (((*(tmp + 4U) == 0x20) && (*(tmp + 2U) == 0x62))  || ((*(tmp + 5U) != 0x00) || (*(tmp + 2U) != 0x62))) {
 								memcpy(m_gps_buffer,tmp,10U);
-								ysfPayload.readVDMode2Data(buffer + 35U, m_gps_buffer + 10U);
+								m_payload.readVDMode2Data(buffer + 35U, m_gps_buffer + 10U);
 								if (first_time) {
 									CUtils::dump("GPS Real info found",m_gps_buffer,20U);
 									first_time = false;
@@ -1024,9 +1058,8 @@ void CStreamer::YSFPlayback(CYSFNetwork *rptNetwork) {
 		if (ysfFrameType == TAG_BULK) {		
 //			CUtils::dump(1U,"Bulk frame",m_ysfFrame,155U);
 			rptNetwork->write(m_ysfFrame);
-			CYSFFICH fich;
-			bool valid = fich.decode(m_ysfFrame + 35U);
-			if (valid && (fich.getFI() == YSF_FI_TERMINATOR)) {
+			bool valid = m_fich.decode(m_ysfFrame + 35U);
+			if (valid && (m_fich.getFI() == YSF_FI_TERMINATOR)) {
 				//LogMessage("End of data playback.");
 				m_rpt_buffer.clear();
 				if (m_jitter_timer) m_jitter_timer->stop();				
@@ -1283,6 +1316,10 @@ void CStreamer::DMR_get_Network(CDMRData tx_dmrdata, unsigned int ms) {
 					m_unlinkReceived = true;
 
 				LogMessage("DMR received end of voice transmission, %.1f seconds", float(m_dmrFrames) / 16.667F);
+				logFEC("DMR AMBE", FEC_DMR_AMBE, m_conv.getDMRStats());
+				m_conv.resetDMRStats();
+				LogDebug("DMR to YSF queue peak %u of %u records, %u frames dropped", m_conv.getYSFQueue().peak(), m_conv.getYSFQueue().capacity(), m_conv.getYSFQueue().overflows());
+				m_conv.resetYSFQueueStats();
 				m_conv.putDMREOT(true);
 				m_open_channel=true;
 				m_dmrNetwork->reset(2U);
@@ -1473,6 +1510,12 @@ static bool sending_silence=false;
 				}										
 				
 				LogMessage("End DMR received end of voice transmission, %.1f seconds", float(m_dmr_cnt) / 16.667F);
+				logFEC("YSF FICH", FEC_YSF_FICH, m_fichStats);
+				logFEC("YSF VCH", FEC_YSF_VCH, m_conv.getYSFStats());
+				m_fichStats.reset();
+				m_conv.resetYSFStats();
+				LogDebug("YSF to DMR queue peak %u of %u records, %u frames dropped", m_conv.getDMRQueue().peak(), m_conv.getDMRQueue().capacity(), m_conv.getDMRQueue().overflows());
+				m_conv.resetDMRQueueStats();
 				rx_dmrdata.setSlotNo(2U);
 				rx_dmrdata.setSrcId(m_srcid);
 				rx_dmrdata.setDstId(m_dstid);
@@ -1592,6 +1635,12 @@ static bool sending_silence=false;
 				}					
 				
 				LogMessage("End DMR received end of voice transmission, %.1f seconds", float(m_dmr_cnt) / 16.667F);
+				logFEC("YSF FICH", FEC_YSF_FICH, m_fichStats);
+				logFEC("YSF VCH", FEC_YSF_VCH, m_conv.getYSFStats());
+				m_fichStats.reset();
+				m_conv.resetYSFStats();
+				LogDebug("YSF to DMR queue peak %u of %u records, %u frames dropped", m_conv.getDMRQueue().peak(), m_conv.getDMRQueue().capacity(), m_conv.getDMRQueue().overflows());
+				m_conv.resetDMRQueueStats();
 				rx_dmrdata.setSlotNo(2U);
 				rx_dmrdata.setSrcId(m_srcid);
 				rx_dmrdata.setDstId(m_dstid);
@@ -1930,6 +1979,13 @@ std::string CStreamer::getSrcYSF_fromFN1(const unsigned char* buffer) {
 	return rcv_callsign;
 }
 
+void CStreamer::logFEC(const char* name, FEC_SOURCE source, const CFECStats& stats)
+{
+	LogMessage("%s FEC: %llu bits, %llu errors, %llu uncorrectable, BER: %.2f%%", name, stats.m_bits, stats.m_errors, stats.m_uncorrectable, stats.getBER());
+
+	m_metrics.add(source, stats);
+}
+
 void CStreamer::processWiresX(const unsigned char* buffer, unsigned char fi, unsigned char dt, unsigned char fn, unsigned char ft, unsigned char bn, unsigned char bt)
 {
 	unsigned int connections=0;
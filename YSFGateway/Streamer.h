@@ -44,6 +44,8 @@
 #include "YSFDefines.h"
 #include "YSFPayload.h"
 #include "FCSNetwork.h"
+#include "FECStats.h"
+#include "Metrics.h"
 
 #include <string>
 
@@ -118,6 +120,13 @@ private:
     bool             m_not_busy;
     bool             m_open_channel;
 	CModeConv        m_conv;
+	CYSFFICH         m_fich;
+	CYSFPayload      m_payload;
+	CFECStats        m_fichStats;
+	CMetrics         m_metrics;
+	bool             m_metricsEnabled;
+	std::string      m_metricsFile;
+	CTimer           m_metricsTimer;
 	std::string      m_rcv_callsign;
     std::string      m_real_rcv_callsign;
 	unsigned char    m_gid;
@@ -180,6 +189,7 @@ private:
     std::string getSrcYSF_fromModem(const unsigned char* buffer);    
     unsigned int findYSFID(std::string cs, bool showdst);
 //    void processDTMF(unsigned char* buffer, unsigned char dt);
+    void logFEC(const char* name, FEC_SOURCE source, const CFECStats& stats);
     void processWiresX(const unsigned char* buffer, unsigned char fi, unsigned char dt, unsigned char fn, unsigned char ft, unsigned char bn, unsigned char bt);
 
 
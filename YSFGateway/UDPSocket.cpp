@@ -26,6 +26,87 @@
 #include <cstring>
 #endif
 
+CUDPRing::CUDPRing(unsigned int slots, unsigned int length) :
+m_slots(slots),
+m_length(length),
+m_slab(NULL),
+m_count(0U),
+m_datagrams(slots),
+m_addrs(slots)
+#if defined(__linux__)
+,
+m_iovs(slots),
+m_msgs(slots)
+#endif
+{
+	assert(slots > 0U);
+	assert(length > 0U);
+
+	m_slab = new unsigned char[slots * length];
+
+	for (unsigned int i = 0U; i < slots; i++) {
+		m_datagrams[i].m_data = m_slab + i * length;
+
+#if defined(__linux__)
+		m_iovs[i].iov_base = m_slab + i * length;
+		m_iovs[i].iov_len  = length;
+
+		::memset(&m_msgs[i], 0x00, sizeof(mmsghdr));
+		m_msgs[i].msg_hdr.msg_name    = &m_addrs[i];
+		m_msgs[i].msg_hdr.msg_iov     = &m_iovs[i];
+		m_msgs[i].msg_hdr.msg_iovlen  = 1U;
+#endif
+	}
+}
+
+CUDPRing::~CUDPRing()
+{
+	delete[] m_slab;
+}
+
+CUDPDatagram& CUDPRing::at(unsigned int n)
+{
+	assert(n < m_count);
+
+	return m_datagrams[n];
+}
+
+unsigned int CUDPRing::size() const
+{
+	return m_count;
+}
+
+bool CUDPRing::isFull() const
+{
+	return m_count == m_slots;
+}
+
+void CUDPRing::clear()
+{
+	m_count = 0U;
+}
+
+void CUDPRing::discard(unsigned int n)
+{
+	assert(n <= m_count);
+
+	if (n == 0U)
+		return;
+
+	for (unsigned int i = n; i < m_count; i++) {
+		CUDPDatagram& from = m_datagrams[i];
+		CUDPDatagram& to   = m_datagrams[i - n];
+
+		// Each datagram keeps the slot it was given
+		::memcpy((unsigned char*)to.m_data, from.m_data, from.m_length);
+		to.m_length  = from.m_length;
+		to.m_address = from.m_address;
+		to.m_port    = from.m_port;
+	}
+
+	m_count -= n;
+}
+
 
 CUDPSocket::CUDPSocket(const std::string& address, unsigned int port) :
 m_address(address),
@@ -163,14 +244,11 @@ int CUDPSocket::read(unsigned char* buffer, unsigned int length, in_addr& addres
 	assert(buffer != NULL);
 	assert(length > 0U);
 
+#if defined(_WIN32) || defined(_WIN64)
 	// Check that the readfrom() won't block
 	fd_set readFds;
 	FD_ZERO(&readFds);
-#if defined(_WIN32) || defined(_WIN64)
 	FD_SET((unsigned int)m_fd, &readFds);
-#else
-	FD_SET(m_fd, &readFds);
-#endif
 
 	// Return immediately
 	timeval tv;
@@ -179,16 +257,13 @@ int CUDPSocket::read(unsigned char* buffer, unsigned int length, in_addr& addres
 
 	int ret = ::select(m_fd + 1, &readFds, NULL, NULL, &tv);
 	if (ret < 0) {
-#if defined(_WIN32) || defined(_WIN64)
 		LogError("Error returned from UDP select, err: %lu", ::GetLastError());
-#else
-		LogError("Error returned from UDP select, err: %d", errno);
-#endif
 		return -1;
 	}
 
 	if (ret == 0)
 		return 0;
+#endif
 
 	sockaddr_in addr;
 #if defined(_WIN32) || defined(_WIN64)
@@ -200,7 +275,10 @@ int CUDPSocket::read(unsigned char* buffer, unsigned int length, in_addr& addres
 #if defined(_WIN32) || defined(_WIN64)
 	int len = ::recvfrom(m_fd, (char*)buffer, length, 0, (sockaddr *)&addr, &size);
 #else
-	ssize_t len = ::recvfrom(m_fd, (char*)buffer, length, 0, (sockaddr *)&addr, &size);
+	// Return immediately, without a select() first
+	ssize_t len = ::recvfrom(m_fd, (char*)buffer, length, MSG_DONTWAIT, (sockaddr *)&addr, &size);
+	if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		return 0;
 #endif
 	if (len <= 0) {
 #if defined(_WIN32) || defined(_WIN64)
@@ -217,6 +295,53 @@ int CUDPSocket::read(unsigned char* buffer, unsigned int length, in_addr& addres
 	return len;
 }
 
+int CUDPSocket::read(CUDPRing& ring)
+{
+	unsigned int start = ring.m_count;
+	if (start == ring.m_slots)
+		return 0;
+
+#if defined(__linux__)
+	for (unsigned int i = start; i < ring.m_slots; i++)
+		ring.m_msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+
+	int ret = ::recvmmsg(m_fd, &ring.m_msgs[start], ring.m_slots - start, MSG_DONTWAIT, NULL);
+	if (ret < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+			return 0;
+
+		LogError("Error returned from recvmmsg, err: %d", errno);
+		return -1;
+	}
+
+	for (int i = 0; i < ret; i++) {
+		CUDPDatagram& datagram = ring.m_datagrams[start + i];
+		datagram.m_length  = ring.m_msgs[start + i].msg_len;
+		datagram.m_address = ring.m_addrs[start + i].sin_addr;
+		datagram.m_port    = ntohs(ring.m_addrs[start + i].sin_port);
+	}
+
+	ring.m_count += ret;
+
+	return ret;
+#else
+	while (ring.m_count < ring.m_slots) {
+		CUDPDatagram& datagram = ring.m_datagrams[ring.m_count];
+
+		int len = read(ring.m_slab + ring.m_count * ring.m_length, ring.m_length, datagram.m_address, datagram.m_port);
+		if (len < 0)
+			return -1;
+		if (len == 0)
+			break;
+
+		datagram.m_length = len;
+		ring.m_count++;
+	}
+
+	return int(ring.m_count - start);
+#endif
+}
+
 bool CUDPSocket::write(const unsigned char* buffer, unsigned int length, const in_addr& address, unsigned int port)
 {
 	assert(buffer != NULL);
@@ -20,6 +20,7 @@
 #define UDPSocket_H
 
 #include <string>
+#include <vector>
 
 #if !defined(_WIN32) && !defined(_WIN64)
 #include <netdb.h>
@@ -34,6 +35,59 @@
 #include <winsock.h>
 #endif
 
+// A view of a received datagram, which stays in its slot until the ring is
+// cleared
+class CUDPDatagram {
+public:
+	CUDPDatagram() :
+	m_data(NULL),
+	m_length(0U),
+	m_address(),
+	m_port(0U)
+	{
+	}
+
+	const unsigned char* m_data;
+	unsigned int         m_length;
+	in_addr              m_address;
+	unsigned int         m_port;
+};
+
+// A preallocated slab of fixed size slots for CUDPSocket::read(), which fills
+// the free ones in a single recvmmsg() call where there is one.
+class CUDPRing {
+public:
+	CUDPRing(unsigned int slots, unsigned int length);
+	~CUDPRing();
+
+	CUDPDatagram& at(unsigned int n);
+
+	unsigned int size() const;
+	bool isFull() const;
+
+	void clear();
+
+	// Drops the first datagrams and moves the rest to the front
+	void discard(unsigned int n);
+
+private:
+	friend class CUDPSocket;
+
+	unsigned int              m_slots;
+	unsigned int              m_length;
+	unsigned char*            m_slab;
+	unsigned int              m_count;
+	std::vector<CUDPDatagram> m_datagrams;
+	std::vector<sockaddr_in>  m_addrs;
+#if defined(__linux__)
+	std::vector<iovec>        m_iovs;
+	std::vector<mmsghdr>      m_msgs;
+#endif
+
+	CUDPRing(const CUDPRing&);
+	CUDPRing& operator=(const CUDPRing&);
+};
+
 class CUDPSocket {
 public:
 	CUDPSocket(const std::string& address, unsigned int port = 0U);
@@ -43,6 +97,8 @@ public:
 	bool open();
 
 	int  read(unsigned char* buffer, unsigned int length, in_addr& address, unsigned int& port);
+	// Returns the number of datagrams added to the ring
+	int  read(CUDPRing& ring);
 	bool write(const unsigned char* buffer, unsigned int length, const in_addr& address, unsigned int port);
 
 	void close();
@@ -1,5 +1,5 @@
 /*
- *   Copyright (C) 2009-2016 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2009-2016,2018 by Jonathan Naylor G4KLX
  *
  *   This program is free software; you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -22,6 +22,12 @@
 #include <cassert>
 #include <cstring>
 
+// NO_SSE2 builds the scalar code on any machine, for ViterbiCheck
+#if !defined(NO_SSE2) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define	USE_SSE2
+#include <emmintrin.h>
+#endif
+
 const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
 
 #define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
@@ -35,24 +41,26 @@ const unsigned int NUM_OF_STATES = 16U;
 const uint32_t     M = 2U;
 const unsigned int K = 5U;
 
+#if defined(USE_SSE2)
+// The branch metrics of the eight butterflies for each pair of received bits,
+// indexed by s0 * 2 + s1. The complement, M - metric, is the entry for the
+// inverted bits, index ^ 3.
+const uint16_t BRANCH_METRICS[4U][NUM_OF_STATES_D2] = {
+	{0U, 1U, 1U, 0U, 1U, 2U, 2U, 1U},
+	{1U, 0U, 0U, 1U, 2U, 1U, 1U, 2U},
+	{1U, 2U, 2U, 1U, 0U, 1U, 1U, 0U},
+	{2U, 1U, 1U, 2U, 1U, 0U, 0U, 1U}};
+#endif
+
 CYSFConvolution::CYSFConvolution() :
-m_metrics1(NULL),
-m_metrics2(NULL),
 m_oldMetrics(NULL),
 m_newMetrics(NULL),
-m_decisions(NULL),
 m_dp(NULL)
 {
-	m_metrics1  = new uint16_t[16U];
-	m_metrics2  = new uint16_t[16U];
-	m_decisions = new uint64_t[180U];
 }
 
 CYSFConvolution::~CYSFConvolution()
 {
-	delete[] m_metrics1;
-	delete[] m_metrics2;
-	delete[] m_decisions;
 }
 
 void CYSFConvolution::start()
@@ -67,33 +75,65 @@ void CYSFConvolution::start()
 
 void CYSFConvolution::decode(uint8_t s0, uint8_t s1)
 {
-  *m_dp = 0U;
+	assert(s0 <= 1U && s1 <= 1U);
+	assert((m_dp - m_decisions) < int(YSF_CONVOLUTION_MAX_STEPS));
+
+#if defined(USE_SSE2)
+	// All eight butterflies at once. The metrics never get near 32768 in 180
+	// steps, so the signed comparisons and minimums are safe. A decision is
+	// set when the upper predecessor wins or ties, as in the scalar code.
+	unsigned int n = (s0 << 1) | s1;
+	__m128i metric  = _mm_loadu_si128((const __m128i*)BRANCH_METRICS[n]);
+	__m128i inverse = _mm_loadu_si128((const __m128i*)BRANCH_METRICS[n ^ 3U]);
+
+	__m128i lower = _mm_loadu_si128((const __m128i*)(m_oldMetrics + 0U));
+	__m128i upper = _mm_loadu_si128((const __m128i*)(m_oldMetrics + NUM_OF_STATES_D2));
+
+	__m128i m00 = _mm_add_epi16(lower, metric);
+	__m128i m10 = _mm_add_epi16(upper, inverse);
+	__m128i m01 = _mm_add_epi16(lower, inverse);
+	__m128i m11 = _mm_add_epi16(upper, metric);
 
-  for (uint8_t i = 0U; i < NUM_OF_STATES_D2; i++) {
-    uint8_t j = i * 2U;
+	__m128i new0 = _mm_min_epi16(m00, m10);
+	__m128i new1 = _mm_min_epi16(m01, m11);
 
-    uint16_t metric = (BRANCH_TABLE1[i] ^ s0) + (BRANCH_TABLE2[i] ^ s1);
+	_mm_storeu_si128((__m128i*)(m_newMetrics + 0U), _mm_unpacklo_epi16(new0, new1));
+	_mm_storeu_si128((__m128i*)(m_newMetrics + NUM_OF_STATES_D2), _mm_unpackhi_epi16(new0, new1));
 
-    uint16_t m0 = m_oldMetrics[i] + metric;
-    uint16_t m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + (M - metric);
-    uint8_t decision0 = (m0 >= m1) ? 1U : 0U;
-    m_newMetrics[j + 0U] = decision0 != 0U ? m1 : m0;
+	// Set where the lower predecessor wins, so the inverse of the decisions
+	__m128i lost0 = _mm_cmpgt_epi16(m10, m00);
+	__m128i lost1 = _mm_cmpgt_epi16(m11, m01);
 
-    m0 = m_oldMetrics[i] + (M - metric);
-    m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + metric;
-    uint8_t decision1 = (m0 >= m1) ? 1U : 0U;
-    m_newMetrics[j + 1U] = decision1 != 0U ? m1 : m0;
+	__m128i lost = _mm_packs_epi16(_mm_unpacklo_epi16(lost0, lost1), _mm_unpackhi_epi16(lost0, lost1));
 
-    *m_dp |= (uint64_t(decision1) << (j + 1U)) | (uint64_t(decision0) << (j + 0U));
-  }
+	*m_dp = uint16_t(~_mm_movemask_epi8(lost));
+#else
+	*m_dp = 0U;
 
-  ++m_dp;
+	for (uint8_t i = 0U; i < NUM_OF_STATES_D2; i++) {
+		uint8_t j = i * 2U;
+
+		uint16_t metric = (BRANCH_TABLE1[i] ^ s0) + (BRANCH_TABLE2[i] ^ s1);
+
+		uint16_t m0 = m_oldMetrics[i] + metric;
+		uint16_t m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + (M - metric);
+		uint8_t decision0 = (m0 >= m1) ? 1U : 0U;
+		m_newMetrics[j + 0U] = decision0 != 0U ? m1 : m0;
+
+		m0 = m_oldMetrics[i] + (M - metric);
+		m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + metric;
+		uint8_t decision1 = (m0 >= m1) ? 1U : 0U;
+		m_newMetrics[j + 1U] = decision1 != 0U ? m1 : m0;
+
+		*m_dp |= (uint16_t(decision1) << (j + 1U)) | (uint16_t(decision0) << (j + 0U));
+	}
+#endif
 
-  assert((m_dp - m_decisions) <= 180);
+	++m_dp;
 
-  uint16_t* tmp = m_oldMetrics;
-  m_oldMetrics = m_newMetrics;
-  m_newMetrics = tmp;
+	uint16_t* tmp = m_oldMetrics;
+	m_oldMetrics = m_newMetrics;
+	m_newMetrics = tmp;
 }
 
 void CYSFConvolution::chainback(unsigned char* out, unsigned int nBits)
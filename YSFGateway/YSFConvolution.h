@@ -1,5 +1,5 @@
 /*
- *   Copyright (C) 2015,2016 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2015,2016,2018 by Jonathan Naylor G4KLX
  *
  *   This program is free software; you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -23,24 +23,34 @@
 
 #include <cstdint>
 
+// The longest input that can be decoded between start() and chainback()
+const unsigned int YSF_CONVOLUTION_MAX_STEPS = 180U;
+
+// A Viterbi decoder for the K=5 rate 1/2 code used by the FICH and the DCH.
+// Everything it needs is held in the object, so decoding does not allocate.
 class CYSFConvolution {
 public:
 	CYSFConvolution();
 	~CYSFConvolution();
 
 	void start();
+
+	// s0 and s1 are hard decisions, 0 or 1
 	void decode(uint8_t s0, uint8_t s1);
 	void chainback(unsigned char* out, unsigned int nBits);
 
 	void encode(const unsigned char* in, unsigned char* out, unsigned int nBits) const;
 
 private:
-	uint16_t* m_metrics1;
-	uint16_t* m_metrics2;
+	uint16_t  m_metrics1[16U];
+	uint16_t  m_metrics2[16U];
 	uint16_t* m_oldMetrics;
 	uint16_t* m_newMetrics;
-	uint64_t* m_decisions;
-	uint64_t* m_dp;
+	uint16_t  m_decisions[YSF_CONVOLUTION_MAX_STEPS];
+	uint16_t* m_dp;
+
+	CYSFConvolution(const CYSFConvolution&);
+	CYSFConvolution& operator=(const CYSFConvolution&);
 };
 
 #endif
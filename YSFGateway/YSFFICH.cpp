@@ -33,6 +33,8 @@ const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U
 #define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
 #define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
 
+const unsigned char BITS_TABLE[] = {0U, 1U, 1U, 2U, 1U, 2U, 2U, 3U, 1U, 2U, 2U, 3U, 2U, 3U, 3U, 4U};
+
 const unsigned int INTERLEAVE_TABLE[] = {
    0U, 40U,  80U, 120U, 160U,
    2U, 42U,  82U, 122U, 162U,
@@ -56,14 +58,14 @@ const unsigned int INTERLEAVE_TABLE[] = {
   38U, 78U, 118U, 158U, 198U};
 
 CYSFFICH::CYSFFICH() :
-m_fich(NULL)
+m_viterbi(),
+m_errors(0U)
 {
-	m_fich  = new unsigned char[6U];
+	::memset(m_fich, 0x00U, 6U);
 }
 
 CYSFFICH::~CYSFFICH()
 {
-	delete[] m_fich;
 }
 
 bool CYSFFICH::decode(const unsigned char* bytes)
@@ -73,10 +75,10 @@ bool CYSFFICH::decode(const unsigned char* bytes)
 	// Skip the sync bytes
 	bytes += YSF_SYNC_LENGTH_BYTES;
 
-	CYSFConvolution viterbi;
-	viterbi.start();
+	m_viterbi.start();
 
 	// Deinterleave the FICH and send bits to the Viterbi decoder
+	unsigned char received[25U];
 	for (unsigned int i = 0U; i < 100U; i++) {
 		unsigned int n = INTERLEAVE_TABLE[i];
 		uint8_t s0 = READ_BIT1(bytes, n) ? 1U : 0U;
@@ -84,23 +86,39 @@ bool CYSFFICH::decode(const unsigned char* bytes)
 		n++;
 		uint8_t s1 = READ_BIT1(bytes, n) ? 1U : 0U;
 
-		viterbi.decode(s0, s1);
+		m_viterbi.decode(s0, s1);
+
+		WRITE_BIT1(received, i * 2U + 0U, s0 != 0U);
+		WRITE_BIT1(received, i * 2U + 1U, s1 != 0U);
 	}
 
 	unsigned char output[13U];
-	viterbi.chainback(output, 96U);
+	m_viterbi.chainback(output, 96U);
+
+	// The bits that were corrected are those that differ from the decoded FICH
+	// when it is coded again, tail bits included, plus those corrected in the
+	// four Golay words
+	output[12U] = 0x00U;
+
+	unsigned char convolved[25U];
+	m_viterbi.encode(output, convolved, 100U);
 
-	unsigned int b0 = CGolay24128::decode24128(output + 0U);
-	unsigned int b1 = CGolay24128::decode24128(output + 3U);
-	unsigned int b2 = CGolay24128::decode24128(output + 6U);
-	unsigned int b3 = CGolay24128::decode24128(output + 9U);
+	m_errors = 0U;
+	for (unsigned int i = 0U; i < 25U; i++) {
+		unsigned char diff = received[i] ^ convolved[i];
+		m_errors += BITS_TABLE[diff >> 4] + BITS_TABLE[diff & 0x0FU];
+	}
+
+	unsigned int b[4U];
+	unsigned char errors[4U];
+	m_errors += CGolay24128::decode24128(output, b, errors, 4U);
 
-	m_fich[0U] = (b0 >> 4) & 0xFFU;
-	m_fich[1U] = ((b0 << 4) & 0xF0U) | ((b1 >> 8) & 0x0FU);
-	m_fich[2U] = (b1 >> 0) & 0xFFU;
-	m_fich[3U] = (b2 >> 4) & 0xFFU;
-	m_fich[4U] = ((b2 << 4) & 0xF0U) | ((b3 >> 8) & 0x0FU);
-	m_fich[5U] = (b3 >> 0) & 0xFFU;
+	m_fich[0U] = (b[0U] >> 4) & 0xFFU;
+	m_fich[1U] = ((b[0U] << 4) & 0xF0U) | ((b[1U] >> 8) & 0x0FU);
+	m_fich[2U] = (b[1U] >> 0) & 0xFFU;
+	m_fich[3U] = (b[2U] >> 4) & 0xFFU;
+	m_fich[4U] = ((b[2U] << 4) & 0xF0U) | ((b[3U] >> 8) & 0x0FU);
+	m_fich[5U] = (b[3U] >> 0) & 0xFFU;
 
 	return CCRC::checkCCITT162(m_fich, 6U);
 }
@@ -139,9 +157,8 @@ void CYSFFICH::encode(unsigned char* bytes)
 	conv[11U] = (c3 >> 0) & 0xFFU;
 	conv[12U] = 0x00U;
 
-	CYSFConvolution convolution;
 	unsigned char convolved[25U];
-	convolution.encode(conv, convolved, 100U);
+	m_viterbi.encode(conv, convolved, 100U);
 
 	unsigned int j = 0U;
 	for (unsigned int i = 0U; i < 100U; i++) {
@@ -160,6 +177,11 @@ void CYSFFICH::encode(unsigned char* bytes)
 	}
 }
 
+unsigned int CYSFFICH::getErrors() const
+{
+	return m_errors;
+}
+
 unsigned char CYSFFICH::getFI() const
 {
 	return (m_fich[0U] >> 6) & 0x03U;
@@ -1,5 +1,5 @@
 /*
- *   Copyright (C) 2015,2016 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2015,2016,2018 by Jonathan Naylor G4KLX
  *   Copyright (C) 2018 by Andy Uribe CA6JAU
  *
  *   This program is free software; you can redistribute it and/or modify
@@ -20,6 +20,11 @@
 #if !defined(YSFFICH_H)
 #define  YSFFICH_H
 
+#include "YSFConvolution.h"
+
+// The coded bits of a FICH, for working out its bit error rate
+const unsigned int YSF_FICH_CODED_BITS = 200U;
+
 class CYSFFICH {
 public:
 	CYSFFICH();
@@ -29,6 +34,9 @@ public:
 
 	void encode(unsigned char* bytes);
 
+	// The bits corrected by the last decode(), by the Viterbi and Golay decoders
+	unsigned int getErrors() const;
+
 	unsigned char getFI() const;
 	unsigned char getCS() const;
 	unsigned char getCM() const;
@@ -57,7 +65,9 @@ public:
 	void load(const unsigned char* fich);
 
 private:
-	unsigned char* m_fich;
+	CYSFConvolution m_viterbi;
+	unsigned char   m_fich[6U];
+	unsigned int    m_errors;
 };
 
 #endif
@@ -67,6 +67,9 @@ const char* HEADER1 = "This software is for use on amateur radio networks only,"
 const char* HEADER2 = "it is to be used for educational purposes only. Its use on";
 const char* HEADER3 = "commercial networks is strictly prohibited.";
 const char* HEADER4 = "Copyright(C) 2018,2019 by CA6JAU, EA7EE, G4KLX and others";
+// The YSF reflector hosts are looked up this many at a time
+const unsigned int RESOLVER_THREADS = 8U;
+
 char const *text_type[6] = {"NONE","YSF ","FCS ","DMR ","NXDN","P25 "};
 
 bool first_time_DMR = true;
@@ -117,6 +120,7 @@ m_fcsReflectors(NULL),
 m_dmrReflectors(NULL),
 m_nxdnReflectors(NULL),
 m_p25Reflectors(NULL),
+m_resolver(NULL),
 m_actual_ref(NULL),
 m_wiresX(NULL),
 m_ptt_pc(false),
@@ -152,7 +156,8 @@ m_xlxConnected(false),
 m_xlxReflectors(NULL),
 m_xlxrefl(0U),
 m_remoteSocket(NULL),
-m_Streamer(NULL)
+m_Streamer(NULL),
+m_ysfPending(0U)
 {
 
 }
@@ -279,6 +284,7 @@ int CYSFGateway::run()
 	unsigned int m_timeout_time = m_conf.getNetworkInactivityTimeout();
 
 	unsigned int reloadTime = m_conf.getNetworkReloadTime();
+	std::string cachePath   = m_conf.getNetworkCachePath();
 	bool wiresXMakeUpper = m_conf.getWiresXMakeUpper();
 
 	ysfNetworkEnabled = m_conf.getYSFNetworkEnabled();
@@ -306,6 +312,7 @@ int CYSFGateway::run()
     LogInfo("    Startup Network Type: %s",	text_type[m_conf.getNetworkTypeStartup()]);
 	LogInfo("    Timeout TG Time: %d min", m_timeout_time);
     LogInfo("    TG List Reload Time: %d min", reloadTime);
+	LogInfo("    TG List Cache: %s", cachePath.empty() ? "none" : cachePath.c_str());
 	LogInfo("    Make Upper: %s", wiresXMakeUpper ? "yes" : "no");
 	LogInfo("    No Change option: %s", m_NoChange ? "yes" : "no");
 	LogInfo("    YSF Enabled: %s", ysfNetworkEnabled ? "yes" : "no");
@@ -398,6 +405,12 @@ int CYSFGateway::run()
 	LogInfo("    P25 List: %s", file_p25.c_str());
 	
 	m_ysfReflectors = new CReflectors(file_ysf, YSF, reloadTime, wiresXMakeUpper);
+
+	// Loading the list never waits for DNS, unresolved reflectors are looked up when used
+	m_resolver = new CHostResolver(m_conf.getYSFNetworkHostsCache(), RESOLVER_THREADS);
+	if (m_resolver->start())
+		m_ysfReflectors->setResolver(m_resolver);
+
 	m_fcsReflectors = new CReflectors(file_fcs, FCS, reloadTime, wiresXMakeUpper);
 	if (m_conf.getDMRNetworkEnableUnlink()) m_dmrReflectors = new CReflectors(file_dmr, DMR, reloadTime, wiresXMakeUpper);
 	else m_dmrReflectors = new CReflectors(file_dmr, DMRP, reloadTime, wiresXMakeUpper);
@@ -407,6 +420,7 @@ int CYSFGateway::run()
 	std::string fileName    = m_conf.getDMRXLXFile();
 	if (!fileName.empty()) {
 		m_xlxReflectors = new CReflectors(fileName, DMR, reloadTime, wiresXMakeUpper);
+		m_xlxReflectors->setCachePath(cachePath);
 		m_xlxReflectors->load();
 	}
 
@@ -421,11 +435,17 @@ int CYSFGateway::run()
 	m_ysf2p25Address = CUDPSocket::lookup(m_conf.getYSFNetworkYSF2P25Address());
 	m_ysf2p25Port = m_conf.getYSFNetworkYSF2P25Port();
 
-	m_ysfReflectors->load();
-	m_fcsReflectors->load();
-	m_dmrReflectors->load();
-	m_nxdnReflectors->load();
-	m_p25Reflectors->load();
+	m_ysfReflectors->setCachePath(cachePath);
+	m_fcsReflectors->setCachePath(cachePath);
+	m_dmrReflectors->setCachePath(cachePath);
+	m_nxdnReflectors->setCachePath(cachePath);
+	m_p25Reflectors->setCachePath(cachePath);
+
+	m_ysfReflectors->read();
+	m_fcsReflectors->read();
+	m_dmrReflectors->read();
+	m_nxdnReflectors->read();
+	m_p25Reflectors->read();
 
 	// m_ysfReflectors->reload();
 	// m_fcsReflectors->reload();
@@ -466,6 +486,16 @@ int CYSFGateway::run()
 			delete m_xlxReflectors;	
 
 		delete m_Streamer;
+
+		// Their reload threads use the resolver
+		delete m_ysfReflectors;
+		delete m_fcsReflectors;
+		delete m_dmrReflectors;
+		delete m_nxdnReflectors;
+		delete m_p25Reflectors;
+
+		m_resolver->stop();
+		delete m_resolver;
 		
 		::LogFinalise();
 
@@ -500,11 +530,14 @@ int CYSFGateway::run()
 		rptNetwork.clock(ms);
 		if (m_dmrNetwork) m_dmrNetwork->clock(ms);
 
-		m_ysfReflectors->clock(ms);
-		m_fcsReflectors->clock(ms);
-		m_dmrReflectors->clock(ms);
-		m_nxdnReflectors->clock(ms);
-		m_p25Reflectors->clock(ms);
+		m_ysfReflectors->clock();
+		m_fcsReflectors->clock();
+		m_dmrReflectors->clock();
+		m_nxdnReflectors->clock();
+		m_p25Reflectors->clock();
+
+		if (m_ysfPending != 0U)
+			connectPending();
 		
 		if (m_ysfNetwork != NULL)
 			m_ysfNetwork->clock(ms);
@@ -533,7 +566,7 @@ int CYSFGateway::run()
 		}
 		
 		if (m_xlxReflectors != NULL)
-			m_xlxReflectors->clock(ms);
+			m_xlxReflectors->clock();
 				
 		m_lostTimer.clock(ms);
 /*		if (m_lostTimer.isRunning() && m_lostTimer.hasExpired()) {
@@ -570,7 +603,10 @@ int CYSFGateway::run()
 				if (ret) {
 					LogMessage("Connected to %05d - \"%s\" has been requested by %10.10s", tmp_dstid, m_Streamer->getNetDst().c_str(), m_Streamer->get_ysfcallsign().c_str());
 					if ((m_tg_type == YSF) || (m_tg_type == FCS))m_wiresX->SendCReply();
-				} 
+				} else if (m_ysfPending == tmp_dstid) {
+					// connectPending() finishes it and sends the reply
+					LogMessage("Connect to %05d requested by %10.10s waits for its host to be resolved", tmp_dstid, m_Streamer->get_ysfcallsign().c_str());
+				}
 				// else {
 				// 	LogMessage("Error with connect");
 				// 	m_wiresX->SendDReply();
@@ -611,6 +647,16 @@ int CYSFGateway::run()
 
 	delete m_Streamer;
 //	delete m_storage;
+
+	// Their reload threads use the resolver
+	delete m_ysfReflectors;
+	delete m_fcsReflectors;
+	delete m_dmrReflectors;
+	delete m_nxdnReflectors;
+	delete m_p25Reflectors;
+
+	m_resolver->stop();
+	delete m_resolver;
 	
 	::LogFinalise();
 
@@ -675,6 +721,29 @@ bool is_number(const std::string& s)
 }
 
 
+// Finishes a connect to a YSF reflector that was waiting for its host
+void CYSFGateway::connectPending()
+{
+	unsigned int dstID = m_ysfPending;
+
+	CReflector* reflector = m_ysfReflectors->findById(std::to_string(dstID));
+	RESOLVE_STATUS status = reflector != NULL ? m_ysfReflectors->resolve(reflector) : RESOLVE_FAILED;
+	if (status == RESOLVE_PENDING)
+		return;
+
+	m_ysfPending = 0U;
+
+	if (status == RESOLVE_FAILED) {
+		LogMessage("Cannot resolve the host of YSF reflector %u", dstID);
+		return;
+	}
+
+	if (TG_Connect(dstID)) {
+		LogMessage("Connected to %05u - \"%s\" now that its host is resolved", dstID, m_Streamer->getNetDst().c_str());
+		m_wiresX->SendCReply();
+	}
+}
+
 void CYSFGateway::startupReLinking()
 {
 	int tmp_id = m_conf.getNetworkTypeStartup();
@@ -803,6 +872,10 @@ bool CYSFGateway::startupLinking()
 			LogMessage("Automatic (re-)connection to %5.5s - \"%s\"", reflector->m_id.c_str(), reflector->m_name.c_str());
 			m_original = dstId;
 			return true;
+		} else if (m_ysfPending == dstId) {
+			LogMessage("Automatic (re-)connection to %5.5s - \"%s\" once its host is resolved", reflector->m_id.c_str(), reflector->m_name.c_str());
+			m_original = dstId;
+			return true;
 		} else LogMessage("Not Possible connection - %d", atoi(reflector->m_id.c_str()));
 	}
 	return false;
@@ -815,6 +888,9 @@ bool CYSFGateway::TG_Connect(unsigned int dstID) {
     TG_TYPE last_type=m_tg_type;
 	int tglistOpt,i;
 
+	// A new connect replaces one still waiting for its host
+	m_ysfPending = 0U;
+
 	if (dstID < 6) {
 		dstID--;
 		if (dstID==0){
@@ -907,6 +983,18 @@ bool CYSFGateway::TG_Connect(unsigned int dstID) {
 				m_lostTimer.stop();
 
 				reflector = m_ysfReflectors->findById(dst_str_ID);
+				if (reflector != NULL) {
+					RESOLVE_STATUS status = m_ysfReflectors->resolve(reflector);
+					if (status == RESOLVE_PENDING) {
+						// The main loop connects once the lookup is done
+						LogMessage("Resolving the host of YSF reflector %s", dst_str_ID.c_str());
+						m_ysfPending = dstID;
+						return false;
+					} else if (status == RESOLVE_FAILED) {
+						LogMessage("Cannot resolve the host of YSF reflector %s", dst_str_ID.c_str());
+						reflector = NULL;
+					}
+				}
 				if (reflector != NULL) {
 					// Close connection
 					if ((last_type == YSF) && (m_ysfNetwork != NULL) ) {
@@ -1505,6 +1593,9 @@ void CYSFGateway::processRemoteCommands()
 				if (ret) {
 					LogMessage("Remote Connected to YSF %05d - \"%s\" has been requested", tmp_dst_id, m_current.c_str());
 					if ((m_tg_type == YSF) || (m_tg_type == FCS)) m_wiresX->SendCReply();
+				} else if (m_ysfPending == (unsigned int)tmp_dst_id) {
+					// connectPending() finishes it
+					LogMessage("Remote connect to YSF %05d waits for its host to be resolved", tmp_dst_id);
 				} else {
 					LogMessage("Remote Error with YSF connect");
 					//m_wiresX->SendDReply();
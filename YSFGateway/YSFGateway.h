@@ -50,6 +50,7 @@ private:
 	CReflectors*    m_dmrReflectors;
 	CReflectors*    m_nxdnReflectors;		
 	CReflectors*    m_p25Reflectors;
+	CHostResolver*  m_resolver;
 	CReflectors*	m_actual_ref;
 	CWiresX*        m_wiresX;
 	bool			m_ptt_pc;
@@ -95,9 +96,11 @@ private:
 	unsigned int     m_current_num;
 	std::string      m_ysfoptions;
 	std::string      m_fcsoptions;
+	unsigned int     m_ysfPending;
 
 	bool startupLinking();
 	void startupReLinking();
+	void connectPending();
 	std::string calculateLocator();
 	void createWiresX(CYSFNetwork* rptNetwork, bool makeUpper, std::string callsign);
 	bool TG_Connect(unsigned int dstID);
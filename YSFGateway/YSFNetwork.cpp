@@ -26,6 +26,8 @@
 #include <cstring>
 
 const unsigned int BUFFER_LENGTH = 200U;
+// The most datagrams taken off the socket in one clock()
+const unsigned int RECEIVE_BUDGET = 64U;
 
 #define YSF_VERSION "YSFG-EA"
 
@@ -38,7 +40,9 @@ m_poll(NULL),
 m_options(NULL),
 m_info(NULL),
 m_unlink(NULL),
-m_buffer(1000U, "YSF Network Buffer"),
+m_ring(RECEIVE_BUDGET, BUFFER_LENGTH),
+m_next(0U),
+m_budgetHits(0U),
 m_pollTimer(1000U, 5U),
 m_name(),
 m_linked(false),
@@ -74,7 +78,9 @@ m_poll(NULL),
 m_options(NULL),
 m_info(NULL),
 m_unlink(NULL),
-m_buffer(1000U, "YSF Network Buffer"),
+m_ring(RECEIVE_BUDGET, BUFFER_LENGTH),
+m_next(0U),
+m_budgetHits(0U),
 m_pollTimer(1000U, 5U),
 m_node()
 {
@@ -211,23 +217,48 @@ unsigned char m_getid[] = "YSFQ";
 
 void CYSFNetwork::clock(unsigned int ms)
 {
-	unsigned char buffer[BUFFER_LENGTH];
-	in_addr address;
-	unsigned int port;
-
 	m_pollTimer.clock(ms);
 	if (m_pollTimer.isRunning() && m_pollTimer.hasExpired())
 		writePoll();
 
-	int length = m_socket.read(buffer, BUFFER_LENGTH, address, port);
-	if (length <= 0)
+	// The slots that have been read are reused, and when none have been the
+	// oldest frame makes way for a new one
+	if (m_next == 0U && m_ring.isFull()) {
+		LogError("**** Overflow in YSF Network ring, frame dropped");
+		m_next = 1U;
+	}
+
+	m_ring.discard(m_next);
+	m_next = 0U;
+
+	unsigned int start = m_ring.size();
+
+	// Everything that is ready is taken, up to the free slots
+	if (m_socket.read(m_ring) <= 0)
 		return;
 
+	// Taking the whole budget in one clock means there may well be more queued
+	if (m_ring.size() - start >= RECEIVE_BUDGET)
+		m_budgetHits++;
+
+	// Anything that isn't for read() is left in its slot with no length
+	for (unsigned int i = start; i < m_ring.size(); i++) {
+		CUDPDatagram& datagram = m_ring.at(i);
+		if (!process(datagram))
+			datagram.m_length = 0U;
+	}
+}
+
+bool CYSFNetwork::process(const CUDPDatagram& datagram)
+{
+	const unsigned char* buffer = datagram.m_data;
+	unsigned int length = datagram.m_length;
+
 	if (m_port == 0U)
-		return;
+		return false;
 
-	if (address.s_addr != m_address.s_addr || port != m_port)
-		return;
+	if (datagram.m_address.s_addr != m_address.s_addr || datagram.m_port != m_port)
+		return false;
 
 	if (::memcmp(buffer, "YSFP", 4U) == 0 && !m_linked) {
 		if (strcmp(m_name.c_str(),"MMDVM")== 0)
@@ -255,15 +286,18 @@ void CYSFNetwork::clock(unsigned int ms)
 	}	
 
 	if ((::memcmp(buffer, "YSFQ", 4U) == 0) && m_linked) {
-		buffer[length]=0;
-		m_room_id = atoi((const char*)(buffer+4));
+		// The reply is parsed as strings, so it needs a copy with a terminator
+		char reply[BUFFER_LENGTH + 1U];
+		::memcpy(reply, buffer, length);
+		reply[length]=0;
+		m_room_id = atoi(reply+4);
 
 
 		if (length>7) {
-			int len = 5 + strlen((const char*)(buffer+4));
-			m_room_connections = atoi((const char*)(buffer+len));
-			len += strlen((const char*)(buffer+len));
-			std::string s((const char*)(buffer+len+1), 10);
+			int len = 5 + strlen(reply+4);
+			m_room_connections = atoi(reply+len);
+			len += strlen(reply+len);
+			std::string s(reply+len+1, 10);
 			m_room_name = s;
 		//	if (m_debug)							
 				LogMessage("DG-ID Packet: room: %d, connections: %d, name:%s",m_room_id, m_room_connections, m_room_name.c_str());
@@ -279,34 +313,41 @@ void CYSFNetwork::clock(unsigned int ms)
 	if (m_debug)
 		CUtils::dump(1U, "YSF Network Data Received", buffer, length);
 
-	unsigned char len = length;
-	m_buffer.addData(&len, 1U);
-
-	m_buffer.addData(buffer, length);
+	return true;
 }
 
 unsigned int CYSFNetwork::read(unsigned char* data)
 {
 	assert(data != NULL);
 
-	if (m_buffer.isEmpty())
-		return 0U;
+	while (m_next < m_ring.size()) {
+		const CUDPDatagram& datagram = m_ring.at(m_next++);
+		if (datagram.m_length == 0U)
+			continue;
 
-	unsigned char len = 0U;
-	m_buffer.getData(&len, 1U);
+		::memcpy(data, datagram.m_data, datagram.m_length);
 
-	m_buffer.getData(data, len);
+		return datagram.m_length;
+	}
 
-	return len;
+	return 0U;
 }
 
 void CYSFNetwork::close()
 {
 	m_socket.close();
 
+	if (m_budgetHits > 0U)
+		LogMessage("The YSF network receive budget was used up %u times", m_budgetHits);
+
 	LogMessage("Closing YSF network connection");
 }
 
+unsigned int CYSFNetwork::getBudgetHits() const
+{
+	return m_budgetHits;
+}
+
 
 bool CYSFNetwork::getRoomInfo(unsigned int& room_id, unsigned int& room_connections, std::string& room_name) {
 	if (m_id_response) {
@@ -21,7 +21,6 @@
 
 #include "YSFDefines.h"
 #include "UDPSocket.h"
-#include "RingBuffer.h"
 #include "Timer.h"
 
 #include <cstdint>
@@ -48,6 +47,9 @@ public:
 
 	void clock(unsigned int ms);
 
+	// How often clock() found more ready than it could take
+	unsigned int getBudgetHits() const;
+
 	bool getRoomInfo(unsigned int& room_id, unsigned int& room_connections, std::string& room_name);
 	bool connected();
 	bool id_getresponse();
@@ -63,7 +65,9 @@ private:
 	unsigned char*             m_options;	
 	unsigned char*             m_info;	
 	unsigned char*             m_unlink;
-	CRingBuffer<unsigned char> m_buffer;
+	CUDPRing                   m_ring;
+	unsigned int               m_next;
+	unsigned int               m_budgetHits;
 	CTimer                     m_pollTimer;
 	std::string                m_name;
 	bool                       m_linked;
@@ -72,6 +76,8 @@ private:
 	unsigned int			   m_room_connections;
 	std::string				   m_room_name;	
 	std::string				   m_node;
+
+	bool process(const CUDPDatagram& datagram);
 };
 
 #endif
@@ -78,19 +78,16 @@ const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U
 #define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
 
 CYSFPayload::CYSFPayload() :
-m_uplink(NULL),
-m_downlink(NULL),
-m_source(NULL),
-m_dest(NULL)
+m_convolution(),
+m_hasUplink(false),
+m_hasDownlink(false),
+m_hasSource(false),
+m_hasDest(false)
 {
 }
 
 CYSFPayload::~CYSFPayload()
 {
-	delete[] m_uplink;
-	delete[] m_downlink;
-	delete[] m_source;
-	delete[] m_dest;
 }
 
 bool CYSFPayload::processHeaderData(unsigned char* data)
@@ -108,8 +105,7 @@ bool CYSFPayload::processHeaderData(unsigned char* data)
 		p1 += 18U; p2 += 9U;
 	}
 
-	CYSFConvolution conv;
-	conv.start();
+	m_convolution.start();
 
 	for (unsigned int i = 0U; i < 180U; i++) {
 		unsigned int n = INTERLEAVE_TABLE_9_20[i];
@@ -118,25 +114,25 @@ bool CYSFPayload::processHeaderData(unsigned char* data)
 		n++;
 		uint8_t s1 = READ_BIT1(dch, n) ? 1U : 0U;
 
-		conv.decode(s0, s1);
+		m_convolution.decode(s0, s1);
 	}
 
 	unsigned char output[23U];
-	conv.chainback(output, 176U);
+	m_convolution.chainback(output, 176U);
 
 	bool valid1 = CCRC::checkCCITT162(output, 22U);
 	if (valid1) {
 		for (unsigned int i = 0U; i < 20U; i++)
 			output[i] ^= WHITENING_DATA[i];
 
-		if (m_dest == NULL) {
-			m_dest = new unsigned char[YSF_CALLSIGN_LENGTH];
+		if (!m_hasDest) {
 			::memcpy(m_dest, output + 0U, YSF_CALLSIGN_LENGTH);
+			m_hasDest = true;
 		}
 
-		if (m_source == NULL) {
-			m_source = new unsigned char[YSF_CALLSIGN_LENGTH];
+		if (!m_hasSource) {
 			::memcpy(m_source, output + YSF_CALLSIGN_LENGTH, YSF_CALLSIGN_LENGTH);
+			m_hasSource = true;
 		}
 
 		for (unsigned int i = 0U; i < 20U; i++)
@@ -146,7 +142,7 @@ bool CYSFPayload::processHeaderData(unsigned char* data)
 		output[22U] = 0x00U;
 
 		unsigned char convolved[45U];
-		conv.encode(output, convolved, 180U);
+		m_convolution.encode(output, convolved, 180U);
 
 		unsigned char bytes[45U];
 		unsigned int j = 0U;
@@ -180,7 +176,7 @@ bool CYSFPayload::processHeaderData(unsigned char* data)
 		p1 += 18U; p2 += 9U;
 	}
 
-	conv.start();
+	m_convolution.start();
 
 	for (unsigned int i = 0U; i < 180U; i++) {
 		unsigned int n = INTERLEAVE_TABLE_9_20[i];
@@ -189,20 +185,20 @@ bool CYSFPayload::processHeaderData(unsigned char* data)
 		n++;
 		uint8_t s1 = READ_BIT1(dch, n) ? 1U : 0U;
 
-		conv.decode(s0, s1);
+		m_convolution.decode(s0, s1);
 	}
 
-	conv.chainback(output, 176U);
+	m_convolution.chainback(output, 176U);
 
 	bool valid2 = CCRC::checkCCITT162(output, 22U);
 	if (valid2) {
 		for (unsigned int i = 0U; i < 20U; i++)
 			output[i] ^= WHITENING_DATA[i];
 
-		if (m_downlink != NULL)
+		if (m_hasDownlink)
 			::memcpy(output + 0U, m_downlink, YSF_CALLSIGN_LENGTH);
 
-		if (m_uplink != NULL)
+		if (m_hasUplink)
 			::memcpy(output + YSF_CALLSIGN_LENGTH, m_uplink, YSF_CALLSIGN_LENGTH);
 
 		for (unsigned int i = 0U; i < 20U; i++)
@@ -212,7 +208,7 @@ bool CYSFPayload::processHeaderData(unsigned char* data)
 		output[22U] = 0x00U;
 
 		unsigned char convolved[45U];
-		conv.encode(output, convolved, 180U);
+		m_convolution.encode(output, convolved, 180U);
 
 		unsigned char bytes[45U];
 		unsigned int j = 0U;
@@ -260,8 +256,7 @@ bool CYSFPayload::readDataFRModeData1(const unsigned char* data, unsigned char*
 		p1 += 18U; p2 += 9U;
 	}
 
-	CYSFConvolution conv;
-	conv.start();
+	m_convolution.start();
 
 	for (unsigned int i = 0U; i < 180U; i++) {
 		unsigned int n = INTERLEAVE_TABLE_9_20[i];
@@ -270,11 +265,11 @@ bool CYSFPayload::readDataFRModeData1(const unsigned char* data, unsigned char*
 		n++;
 		uint8_t s1 = READ_BIT1(dch, n) ? 1U : 0U;
 
-		conv.decode(s0, s1);
+		m_convolution.decode(s0, s1);
 	}
 
 	unsigned char output[23U];
-	conv.chainback(output, 176U);
+	m_convolution.chainback(output, 176U);
 
 	bool ret = CCRC::checkCCITT162(output, 22U);
 	if (ret) {
@@ -307,8 +302,7 @@ bool CYSFPayload::readDataFRModeData2(const unsigned char* data, unsigned char*
 		p1 += 18U; p2 += 9U;
 	}
 
-	CYSFConvolution conv;
-	conv.start();
+	m_convolution.start();
 
 	for (unsigned int i = 0U; i < 180U; i++) {
 		unsigned int n = INTERLEAVE_TABLE_9_20[i];
@@ -317,11 +311,11 @@ bool CYSFPayload::readDataFRModeData2(const unsigned char* data, unsigned char*
 		n++;
 		uint8_t s1 = READ_BIT1(dch, n) ? 1U : 0U;
 
-		conv.decode(s0, s1);
+		m_convolution.decode(s0, s1);
 	}
 
 	unsigned char output[23U];
-	conv.chainback(output, 176U);
+	m_convolution.chainback(output, 176U);
 
 	bool ret = CCRC::checkCCITT162(output, 22U);
 	if (ret) {
@@ -352,8 +346,7 @@ void CYSFPayload::writeVDMode1Data(unsigned char* data, const unsigned char* dt)
 
 	unsigned char convolved[45U];
 
-	CYSFConvolution conv;
-	conv.encode(output, convolved, 180U);
+	m_convolution.encode(output, convolved, 180U);
 
 	unsigned char bytes[45U];
 	unsigned int j = 0U;
@@ -397,9 +390,8 @@ void CYSFPayload::writeVDMode2Data(unsigned char* data, const unsigned char* dt)
 	dt_tmp[12U] = 0x00U;
 
 	unsigned char convolved[25U];
-	CYSFConvolution conv;
-	conv.start();
-	conv.encode(dt_tmp, convolved, 100U);
+	m_convolution.start();
+	m_convolution.encode(dt_tmp, convolved, 100U);
 
 	unsigned char bytes[25U];
 	unsigned int j = 0U;
@@ -443,8 +435,7 @@ bool CYSFPayload::readVDMode1Data(const unsigned char* data, unsigned char* dt)
 		p1 += 18U; p2 += 9U;
 	}
 
-	CYSFConvolution conv;
-	conv.start();
+	m_convolution.start();
 
 	for (unsigned int i = 0U; i < 180U; i++) {
 		unsigned int n = INTERLEAVE_TABLE_9_20[i];
@@ -453,11 +444,11 @@ bool CYSFPayload::readVDMode1Data(const unsigned char* data, unsigned char* dt)
 		n++;
 		uint8_t s1 = READ_BIT1(dch, n) ? 1U : 0U;
 
-		conv.decode(s0, s1);
+		m_convolution.decode(s0, s1);
 	}
 
 	unsigned char output[23U];
-	conv.chainback(output, 176U);
+	m_convolution.chainback(output, 176U);
 
 	bool ret = CCRC::checkCCITT162(output, 22U);
 	if (ret) {
@@ -489,8 +480,7 @@ bool CYSFPayload::readVDMode2Data(const unsigned char* data, unsigned char* dt)
 		p1 += 18U; p2 += 5U;
 	}
 
-	CYSFConvolution conv;
-	conv.start();
+	m_convolution.start();
 
 	for (unsigned int i = 0U; i < 100U; i++) {
 		unsigned int n = INTERLEAVE_TABLE_5_20[i];
@@ -499,11 +489,11 @@ bool CYSFPayload::readVDMode2Data(const unsigned char* data, unsigned char* dt)
 		n++;
 		uint8_t s1 = READ_BIT1(dch, n) ? 1U : 0U;
 
-		conv.decode(s0, s1);
+		m_convolution.decode(s0, s1);
 	}
 
 	unsigned char output[13U];
-	conv.chainback(output, 96U);
+	m_convolution.chainback(output, 96U);
 
 	bool ret = CCRC::checkCCITT162(output, 12U);
 	if (ret) {
@@ -545,8 +535,7 @@ void CYSFPayload::writeDataFRModeData1(const unsigned char* dt, unsigned char* d
 
 	unsigned char convolved[45U];
 
-	CYSFConvolution conv;
-	conv.encode(output, convolved, 180U);
+	m_convolution.encode(output, convolved, 180U);
 
 	unsigned char bytes[45U];
 	unsigned int j = 0U;
@@ -589,8 +578,7 @@ void CYSFPayload::writeDataFRModeData2(const unsigned char* dt, unsigned char* d
 
 	unsigned char convolved[45U];
 
-	CYSFConvolution conv;
-	conv.encode(output, convolved, 180U);
+	m_convolution.encode(output, convolved, 180U);
 
 	unsigned char bytes[45U];
 	unsigned int j = 0U;
@@ -619,31 +607,31 @@ void CYSFPayload::writeDataFRModeData2(const unsigned char* dt, unsigned char* d
 
 void CYSFPayload::setUplink(const std::string& callsign)
 {
-	m_uplink = new unsigned char[YSF_CALLSIGN_LENGTH];
-
 	std::string uplink = callsign;
 	uplink.resize(YSF_CALLSIGN_LENGTH, ' ');
 
 	for (unsigned int i = 0U; i < YSF_CALLSIGN_LENGTH; i++)
 		m_uplink[i] = uplink.at(i);
+
+	m_hasUplink = true;
 }
 
 void CYSFPayload::setDownlink(const std::string& callsign)
 {
-	m_downlink = new unsigned char[YSF_CALLSIGN_LENGTH];
-
 	std::string downlink = callsign;
 	downlink.resize(YSF_CALLSIGN_LENGTH, ' ');
 
 	for (unsigned int i = 0U; i < YSF_CALLSIGN_LENGTH; i++)
 		m_downlink[i] = downlink.at(i);
+
+	m_hasDownlink = true;
 }
 
 std::string CYSFPayload::getSource()
 {
 	std::string tmp;
 
-	if (m_dest)
+	if (m_hasSource)
 		tmp.assign((const char *)m_source, YSF_CALLSIGN_LENGTH);
 	else
 		tmp = "";
@@ -655,7 +643,7 @@ std::string CYSFPayload::getDest()
 {
 	std::string tmp;
 
-	if (m_dest)
+	if (m_hasDest)
 		tmp.assign((const char *)m_dest, YSF_CALLSIGN_LENGTH);
 	else
 		tmp = "";
@@ -665,9 +653,6 @@ std::string CYSFPayload::getDest()
 
 void CYSFPayload::reset()
 {
-	delete[] m_source;
-	delete[] m_dest;
-
-	m_source = NULL;
-	m_dest = NULL;
+	m_hasSource = false;
+	m_hasDest   = false;
 }
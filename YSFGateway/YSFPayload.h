@@ -1,5 +1,5 @@
 /*
-*   Copyright (C) 2016,2017 by Jonathan Naylor G4KLX
+*   Copyright (C) 2016,2017,2018 by Jonathan Naylor G4KLX
 *
 *   This program is free software; you can redistribute it and/or modify
 *   it under the terms of the GNU General Public License as published by
@@ -19,6 +19,9 @@
 #if !defined(YSFPayload_H)
 #define	YSFPayload_H
 
+#include "YSFConvolution.h"
+#include "YSFDefines.h"
+
 #include <string>
 
 class CYSFPayload {
@@ -49,10 +52,15 @@ public:
 	void reset();
 
 private:
-	unsigned char* m_uplink;
-	unsigned char* m_downlink;
-	unsigned char* m_source;
-	unsigned char* m_dest;
+	CYSFConvolution m_convolution;
+	unsigned char   m_uplink[YSF_CALLSIGN_LENGTH];
+	unsigned char   m_downlink[YSF_CALLSIGN_LENGTH];
+	unsigned char   m_source[YSF_CALLSIGN_LENGTH];
+	unsigned char   m_dest[YSF_CALLSIGN_LENGTH];
+	bool            m_hasUplink;
+	bool            m_hasDownlink;
+	bool            m_hasSource;
+	bool            m_hasDest;
 };
 
 #endif
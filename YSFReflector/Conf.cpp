@@ -31,7 +31,9 @@ enum SECTION {
   SECTION_GENERAL,
   SECTION_INFO,
   SECTION_LOG,
-  SECTION_NETWORK
+  SECTION_NETWORK,
+  SECTION_ROOMS,
+  SECTION_METRICS
 };
 
 CConf::CConf(const std::string& file) :
@@ -44,7 +46,12 @@ m_logFileLevel(0U),
 m_logFilePath(),
 m_logFileRoot(),
 m_networkPort(0U),
-m_networkDebug(false)
+m_networkDebug(false),
+m_networkThreads(1U),
+m_rooms(),
+m_metricsEnabled(false),
+m_metricsFile(),
+m_metricsInterval(15U)
 {
 }
 
@@ -76,6 +83,10 @@ bool CConf::read()
 			  section = SECTION_LOG;
 		  else if (::strncmp(buffer, "[Network]", 9U) == 0)
 			  section = SECTION_NETWORK;
+		  else if (::strncmp(buffer, "[Rooms]", 7U) == 0)
+			  section = SECTION_ROOMS;
+		  else if (::strncmp(buffer, "[Metrics]", 9U) == 0)
+			  section = SECTION_METRICS;
 		  else
 			  section = SECTION_NONE;
 
@@ -109,6 +120,28 @@ bool CConf::read()
 			  m_networkPort = (unsigned int)::atoi(value);
 		  else if (::strcmp(key, "Debug") == 0)
 			  m_networkDebug = ::atoi(value) == 1;
+		  else if (::strcmp(key, "Threads") == 0)
+			  m_networkThreads = (unsigned int)::atoi(value);
+	  } else if (section == SECTION_ROOMS) {
+		  if (::strcmp(key, "Room") == 0) {
+			  char* p1 = ::strtok(value, ",\r\n");
+			  char* p2 = ::strtok(NULL, ",\r\n");
+			  char* p3 = ::strtok(NULL, "\r\n");
+			  if (p1 != NULL && p2 != NULL && p3 != NULL) {
+				  CConfRoom room;
+				  room.m_dgId        = (unsigned int)::atoi(p1);
+				  room.m_name        = p2;
+				  room.m_description = p3;
+				  m_rooms.push_back(room);
+			  }
+		  }
+	  } else if (section == SECTION_METRICS) {
+		  if (::strcmp(key, "Enable") == 0)
+			  m_metricsEnabled = ::atoi(value) == 1;
+		  else if (::strcmp(key, "File") == 0)
+			  m_metricsFile = value;
+		  else if (::strcmp(key, "Interval") == 0)
+			  m_metricsInterval = (unsigned int)::atoi(value);
 	  }
   }
 
@@ -161,3 +194,28 @@ bool CConf::getNetworkDebug() const
 {
 	return m_networkDebug;
 }
+
+unsigned int CConf::getNetworkThreads() const
+{
+	return m_networkThreads;
+}
+
+std::vector<CConfRoom> CConf::getRooms() const
+{
+	return m_rooms;
+}
+
+bool CConf::getMetricsEnabled() const
+{
+	return m_metricsEnabled;
+}
+
+std::string CConf::getMetricsFile() const
+{
+	return m_metricsFile;
+}
+
+unsigned int CConf::getMetricsInterval() const
+{
+	return m_metricsInterval;
+}
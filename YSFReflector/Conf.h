@@ -22,6 +22,21 @@
 #include <string>
 #include <vector>
 
+class CConfRoom
+{
+public:
+  CConfRoom() :
+  m_dgId(0U),
+  m_name(),
+  m_description()
+  {
+  }
+
+  unsigned int m_dgId;
+  std::string  m_name;
+  std::string  m_description;
+};
+
 class CConf
 {
 public:
@@ -46,6 +61,15 @@ public:
   // The Network section
   unsigned int getNetworkPort() const;
   bool         getNetworkDebug() const;
+  unsigned int getNetworkThreads() const;
+
+  // The Rooms section
+  std::vector<CConfRoom> getRooms() const;
+
+  // The Metrics section
+  bool         getMetricsEnabled() const;
+  std::string  getMetricsFile() const;
+  unsigned int getMetricsInterval() const;
 
 private:
   std::string  m_file;
@@ -61,6 +85,13 @@ private:
 
   unsigned int m_networkPort;
   bool         m_networkDebug;
+  unsigned int m_networkThreads;
+
+  std::vector<CConfRoom> m_rooms;
+
+  bool         m_metricsEnabled;
+  std::string  m_metricsFile;
+  unsigned int m_metricsInterval;
 };
 
 #endif
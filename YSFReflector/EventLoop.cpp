@@ -0,0 +1,338 @@
+/*
+ *   Copyright (C) 2026 by agent
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "EventLoop.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstring>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#elif defined(_WIN32) || defined(_WIN64)
+#include <winsock.h>
+#else
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/select.h>
+#include <cerrno>
+#endif
+
+const unsigned int MAX_EVENTS = 16U;
+
+CEventLoop::CEventLoop() :
+m_fd(-1),
+m_sources(),
+m_stopWatch(),
+m_now(0ULL),
+m_last(0U)
+{
+}
+
+CEventLoop::~CEventLoop()
+{
+}
+
+bool CEventLoop::open()
+{
+#if defined(__linux__)
+	m_fd = ::epoll_create1(EPOLL_CLOEXEC);
+	if (m_fd < 0) {
+		LogError("Cannot create the epoll instance, err: %d", errno);
+		return false;
+	}
+#endif
+	m_stopWatch.start();
+	m_now  = 0ULL;
+	m_last = 0U;
+
+	return true;
+}
+
+bool CEventLoop::addSocket(unsigned int id, int fd)
+{
+	assert(fd >= 0);
+
+#if defined(__linux__)
+	epoll_event event;
+	::memset(&event, 0x00, sizeof(epoll_event));
+	event.events   = EPOLLIN;
+	event.data.u32 = id;
+
+	if (::epoll_ctl(m_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+		LogError("Cannot add the socket to epoll, err: %d", errno);
+		return false;
+	}
+#endif
+
+	m_sources.push_back(CEventSource(id, fd, false));
+
+	return true;
+}
+
+bool CEventLoop::addTimer(unsigned int id, unsigned int ms, bool periodic)
+{
+	assert(ms > 0U);
+
+	int fd = -1;
+
+#if defined(__linux__)
+	fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (fd < 0) {
+		LogError("Cannot create the timer, err: %d", errno);
+		return false;
+	}
+
+	epoll_event event;
+	::memset(&event, 0x00, sizeof(epoll_event));
+	event.events   = EPOLLIN;
+	event.data.u32 = id;
+
+	if (::epoll_ctl(m_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+		LogError("Cannot add the timer to epoll, err: %d", errno);
+		::close(fd);
+		return false;
+	}
+#endif
+
+	CEventSource source(id, fd, true);
+	source.m_interval = ms;
+	source.m_periodic = periodic;
+	m_sources.push_back(source);
+
+	return true;
+}
+
+void CEventLoop::startTimer(unsigned int id)
+{
+	CEventSource* source = find(id);
+	assert(source != NULL && source->m_timer);
+
+	m_mutex.lock();
+	source->m_running = true;
+	arm(*source);
+	m_mutex.unlock();
+}
+
+void CEventLoop::stopTimer(unsigned int id)
+{
+	CEventSource* source = find(id);
+	assert(source != NULL && source->m_timer);
+
+	m_mutex.lock();
+	if (source->m_running) {
+		source->m_running = false;
+		arm(*source);
+	}
+	m_mutex.unlock();
+}
+
+bool CEventLoop::isTimerRunning(unsigned int id) const
+{
+	bool running = false;
+
+	m_mutex.lock();
+	for (std::vector<CEventSource>::const_iterator it = m_sources.begin(); it != m_sources.end(); ++it) {
+		if ((*it).m_id == id) {
+			running = (*it).m_running;
+			break;
+		}
+	}
+	m_mutex.unlock();
+
+	return running;
+}
+
+void CEventLoop::arm(CEventSource& source)
+{
+#if defined(__linux__)
+	itimerspec spec;
+	::memset(&spec, 0x00, sizeof(itimerspec));
+
+	if (source.m_running) {
+		spec.it_value.tv_sec  = source.m_interval / 1000U;
+		spec.it_value.tv_nsec = (source.m_interval % 1000U) * 1000000L;
+
+		if (source.m_periodic)
+			spec.it_interval = spec.it_value;
+	}
+
+	if (::timerfd_settime(source.m_fd, 0, &spec, NULL) == -1)
+		LogError("Cannot set the timer, err: %d", errno);
+#else
+	unsigned int elapsed = m_stopWatch.elapsed();
+	m_now += elapsed - m_last;
+	m_last = elapsed;
+
+	source.m_deadline = m_now + source.m_interval;
+#endif
+}
+
+unsigned int CEventLoop::wait(unsigned int* ids, unsigned int count)
+{
+	assert(ids != NULL);
+	assert(count > 0U);
+
+#if defined(__linux__)
+	epoll_event events[MAX_EVENTS];
+
+	int n = ::epoll_wait(m_fd, events, count < MAX_EVENTS ? count : MAX_EVENTS, -1);
+	if (n < 0) {
+		if (errno != EINTR)
+			LogError("Error returned from epoll_wait, err: %d", errno);
+		return 0U;
+	}
+
+	unsigned int ready = 0U;
+
+	for (int i = 0; i < n; i++) {
+		unsigned int id = events[i].data.u32;
+
+		CEventSource* source = find(id);
+		if (source == NULL)
+			continue;
+
+		if (source->m_timer) {
+			m_mutex.lock();
+
+			// A timer that was stopped or restarted after firing reads nothing
+			uint64_t expirations;
+			bool expired = ::read(source->m_fd, &expirations, sizeof(uint64_t)) == sizeof(uint64_t);
+			if (expired && !source->m_periodic)
+				source->m_running = false;
+
+			m_mutex.unlock();
+
+			if (!expired)
+				continue;
+		}
+
+		ids[ready++] = id;
+	}
+
+	return ready;
+#else
+	fd_set readFds;
+	FD_ZERO(&readFds);
+
+	int maxFd = -1;
+	for (std::vector<CEventSource>::const_iterator it = m_sources.begin(); it != m_sources.end(); ++it) {
+		if (!(*it).m_timer) {
+#if defined(_WIN32) || defined(_WIN64)
+			FD_SET((unsigned int)(*it).m_fd, &readFds);
+#else
+			FD_SET((*it).m_fd, &readFds);
+#endif
+			if ((*it).m_fd > maxFd)
+				maxFd = (*it).m_fd;
+		}
+	}
+
+	m_mutex.lock();
+
+	unsigned int elapsed = m_stopWatch.elapsed();
+	m_now += elapsed - m_last;
+	m_last = elapsed;
+
+	bool hasTimeout = false;
+	unsigned long long timeout = 0ULL;
+	for (std::vector<CEventSource>::const_iterator it = m_sources.begin(); it != m_sources.end(); ++it) {
+		if ((*it).m_timer && (*it).m_running) {
+			unsigned long long remaining = (*it).m_deadline > m_now ? (*it).m_deadline - m_now : 0ULL;
+			if (!hasTimeout || remaining < timeout)
+				timeout = remaining;
+			hasTimeout = true;
+		}
+	}
+
+	m_mutex.unlock();
+
+	timeval tv;
+	tv.tv_sec  = long(timeout / 1000ULL);
+	tv.tv_usec = long(timeout % 1000ULL) * 1000L;
+
+	int ret = ::select(maxFd + 1, &readFds, NULL, NULL, hasTimeout ? &tv : NULL);
+	if (ret < 0) {
+#if defined(_WIN32) || defined(_WIN64)
+		LogError("Error returned from select, err: %lu", ::GetLastError());
+#else
+		if (errno != EINTR)
+			LogError("Error returned from select, err: %d", errno);
+#endif
+		return 0U;
+	}
+
+	m_mutex.lock();
+
+	elapsed = m_stopWatch.elapsed();
+	m_now += elapsed - m_last;
+	m_last = elapsed;
+
+	unsigned int ready = 0U;
+
+	for (std::vector<CEventSource>::iterator it = m_sources.begin(); it != m_sources.end() && ready < count; ++it) {
+		if ((*it).m_timer) {
+			if (!(*it).m_running || (*it).m_deadline > m_now)
+				continue;
+
+			if ((*it).m_periodic)
+				(*it).m_deadline += (*it).m_interval;
+			else
+				(*it).m_running = false;
+		} else {
+			if (ret == 0 || !FD_ISSET((*it).m_fd, &readFds))
+				continue;
+		}
+
+		ids[ready++] = (*it).m_id;
+	}
+
+	m_mutex.unlock();
+
+	return ready;
+#endif
+}
+
+void CEventLoop::close()
+{
+#if defined(__linux__)
+	for (std::vector<CEventSource>::const_iterator it = m_sources.begin(); it != m_sources.end(); ++it) {
+		if ((*it).m_timer)
+			::close((*it).m_fd);
+	}
+
+	::close(m_fd);
+	m_fd = -1;
+#endif
+
+	m_sources.clear();
+}
+
+CEventSource* CEventLoop::find(unsigned int id)
+{
+	for (std::vector<CEventSource>::iterator it = m_sources.begin(); it != m_sources.end(); ++it) {
+		if ((*it).m_id == id)
+			return &(*it);
+	}
+
+	return NULL;
+}
@@ -0,0 +1,83 @@
+/*
+ *   Copyright (C) 2026 by agent
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(EVENTLOOP_H)
+#define	EVENTLOOP_H
+
+#include "StopWatch.h"
+#include "Mutex.h"
+
+#include <vector>
+
+class CEventSource {
+public:
+	CEventSource(unsigned int id, int fd, bool timer) :
+	m_id(id),
+	m_fd(fd),
+	m_timer(timer),
+	m_interval(0U),
+	m_periodic(false),
+	m_running(false),
+	m_deadline(0ULL)
+	{
+	}
+
+	unsigned int       m_id;
+	int                m_fd;
+	bool               m_timer;
+	unsigned int       m_interval;
+	bool               m_periodic;
+	bool               m_running;
+	unsigned long long m_deadline;
+};
+
+// Waits for sockets to become readable or timers to expire. On Linux this is
+// epoll with one timerfd per timer, elsewhere select() with software timers.
+// Timers may be started and stopped from other threads.
+class CEventLoop {
+public:
+	CEventLoop();
+	~CEventLoop();
+
+	bool open();
+
+	bool addSocket(unsigned int id, int fd);
+	bool addTimer(unsigned int id, unsigned int ms, bool periodic);
+
+	void startTimer(unsigned int id);
+	void stopTimer(unsigned int id);
+	bool isTimerRunning(unsigned int id) const;
+
+	// Blocks until something happens and returns the ids of the ready sources
+	unsigned int wait(unsigned int* ids, unsigned int count);
+
+	void close();
+
+private:
+	int                       m_fd;
+	std::vector<CEventSource> m_sources;
+	CStopWatch                m_stopWatch;
+	unsigned long long        m_now;
+	unsigned int              m_last;
+	mutable CMutex            m_mutex;
+
+	CEventSource* find(unsigned int id);
+	void arm(CEventSource& source);
+};
+
+#endif
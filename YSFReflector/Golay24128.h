@@ -0,0 +1,45 @@
+/*
+ *   Copyright (C) 2010,2016,2018 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef Golay24128_H
+#define Golay24128_H
+
+// The error count of a codeword with more errors than can be corrected
+const unsigned char GOLAY24128_UNCORRECTABLE = 0xFFU;
+
+class CGolay24128 {
+public:
+	static unsigned int encode23127(unsigned int data);
+	static unsigned int encode24128(unsigned int data);
+
+	static unsigned int decode23127(unsigned int code);
+	static unsigned int decode24128(unsigned int code);
+	static unsigned int decode24128(unsigned char* bytes);
+
+	// As above, also setting errors to the number of bits corrected. For the
+	// (24,12) code that counts the parity bit, or is GOLAY24128_UNCORRECTABLE.
+	static unsigned int decode23127(unsigned int code, unsigned int& errors);
+	static unsigned int decode24128(unsigned int code, unsigned int& errors);
+
+	// Decodes n codewords packed three bytes to each, as above, into data.
+	// errors gets the number of bits corrected in each, counting the parity
+	// bit, or GOLAY24128_UNCORRECTABLE. Returns the total number corrected.
+	static unsigned int decode24128(const unsigned char* bytes, unsigned int* data, unsigned char* errors, unsigned int n);
+};
+
+#endif
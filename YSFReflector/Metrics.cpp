@@ -0,0 +1,264 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "Metrics.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <arpa/inet.h>
+#endif
+
+// In microseconds, the last bucket has no bound
+const unsigned long long LATENCY_BOUNDS[LATENCY_BUCKETS - 1U] = {10ULL, 25ULL, 50ULL, 100ULL, 250ULL, 500ULL, 1000ULL, 2500ULL, 5000ULL, 10000ULL, 25000ULL, 100000ULL};
+
+CLatencyHistogram::CLatencyHistogram()
+{
+	clear();
+}
+
+void CLatencyHistogram::add(unsigned long long latency)
+{
+	unsigned int n = 0U;
+	while (n < LATENCY_BUCKETS - 1U && latency > LATENCY_BOUNDS[n])
+		n++;
+
+	m_buckets[n]++;
+	m_sum += latency;
+	m_count++;
+}
+
+void CLatencyHistogram::add(const CLatencyHistogram& histogram)
+{
+	for (unsigned int i = 0U; i < LATENCY_BUCKETS; i++)
+		m_buckets[i] += histogram.m_buckets[i];
+
+	m_sum   += histogram.m_sum;
+	m_count += histogram.m_count;
+}
+
+void CLatencyHistogram::clear()
+{
+	for (unsigned int i = 0U; i < LATENCY_BUCKETS; i++)
+		m_buckets[i] = 0ULL;
+
+	m_sum   = 0ULL;
+	m_count = 0ULL;
+}
+
+CRelayCounters::CRelayCounters() :
+m_packetsIn(),
+m_bytesIn(),
+m_latency(),
+m_unlinked(0ULL),
+m_sendErrors(0ULL),
+m_changed(false)
+{
+	::memset(m_roomPackets, 0x00, MAX_ROOMS * sizeof(unsigned long long));
+	::memset(m_roomBytes, 0x00, MAX_ROOMS * sizeof(unsigned long long));
+}
+
+void CRelayCounters::reset(unsigned int peers)
+{
+	m_packetsIn.assign(peers, 0ULL);
+	m_bytesIn.assign(peers, 0ULL);
+
+	::memset(m_roomPackets, 0x00, MAX_ROOMS * sizeof(unsigned long long));
+	::memset(m_roomBytes, 0x00, MAX_ROOMS * sizeof(unsigned long long));
+
+	m_latency.clear();
+
+	m_unlinked   = 0ULL;
+	m_sendErrors = 0ULL;
+	m_changed    = false;
+}
+
+CMetrics::CMetrics() :
+m_latency(),
+m_packetsIn(0ULL),
+m_bytesIn(0ULL),
+m_packetsOut(0ULL),
+m_bytesOut(0ULL),
+m_unlinked(0ULL),
+m_sendErrors(0ULL),
+m_polls(0ULL)
+{
+}
+
+CMetrics::~CMetrics()
+{
+}
+
+void CMetrics::add(const CPeerList& peers, const CRelayCounters& counters, CRepeaters& repeaters)
+{
+	assert(counters.m_packetsIn.size() == peers.size());
+
+	m_latency.add(counters.m_latency);
+
+	m_unlinked   += counters.m_unlinked;
+	m_sendErrors += counters.m_sendErrors;
+
+	for (unsigned int i = 0U; i < peers.size(); i++) {
+		const CPeer& peer = peers.m_peers[i];
+
+		unsigned long long packetsIn  = counters.m_packetsIn[i];
+		unsigned long long bytesIn    = counters.m_bytesIn[i];
+		unsigned long long packetsOut = counters.m_roomPackets[peer.m_room] - packetsIn;
+		unsigned long long bytesOut   = counters.m_roomBytes[peer.m_room] - bytesIn;
+
+		m_packetsIn  += packetsIn;
+		m_bytesIn    += bytesIn;
+		m_packetsOut += packetsOut;
+		m_bytesOut   += bytesOut;
+
+		if (packetsIn == 0ULL && packetsOut == 0ULL)
+			continue;
+
+		// The repeater may have gone since the thread took its copy
+		unsigned int n = repeaters.find(peer.m_address, peer.m_port);
+		if (n == REPEATER_NOT_FOUND)
+			continue;
+
+		CYSFRepeater& rpt = repeaters.at(n);
+		rpt.m_packetsIn  += packetsIn;
+		rpt.m_bytesIn    += bytesIn;
+		rpt.m_packetsOut += packetsOut;
+		rpt.m_bytesOut   += bytesOut;
+	}
+}
+
+void CMetrics::pollReceived(CYSFRepeater& repeater, unsigned long long now)
+{
+	if (repeater.m_polls > 0ULL)
+		repeater.m_pollInterval = now - repeater.m_pollTime;
+
+	repeater.m_pollTime = now;
+	repeater.m_polls++;
+
+	m_polls++;
+}
+
+static void writeLabel(FILE* fp, const CYSFRepeater& repeater)
+{
+	// The callsign comes off the network, so keep to what a label value allows
+	char callsign[20U];
+	unsigned int n = 0U;
+	for (std::string::const_iterator it = repeater.m_callsign.begin(); it != repeater.m_callsign.end() && n < 19U; ++it) {
+		char c = *it;
+		if (c > ' ' && c <= '~' && c != '"' && c != '\\')
+			callsign[n++] = c;
+	}
+	callsign[n] = '\0';
+
+	::fprintf(fp, "{callsign=\"%s\",address=\"%s:%u\",dgid=\"%u\"}", callsign, ::inet_ntoa(repeater.m_address), repeater.m_port, repeater.m_room);
+}
+
+static void writeCounter(FILE* fp, const char* name, const char* help, const CRepeaters& repeaters, unsigned long long CYSFRepeater::* counter, unsigned long long total)
+{
+	::fprintf(fp, "# HELP ysfreflector_%s %s\n", name, help);
+	::fprintf(fp, "# TYPE ysfreflector_%s counter\n", name);
+	::fprintf(fp, "ysfreflector_%s %llu\n", name, total);
+
+	::fprintf(fp, "# HELP ysfreflector_repeater_%s %s\n", name, help);
+	::fprintf(fp, "# TYPE ysfreflector_repeater_%s counter\n", name);
+	for (unsigned int i = 0U; i < repeaters.size(); i++) {
+		const CYSFRepeater& rpt = repeaters.at(i);
+		::fprintf(fp, "ysfreflector_repeater_%s", name);
+		writeLabel(fp, rpt);
+		::fprintf(fp, " %llu\n", rpt.*counter);
+	}
+}
+
+bool CMetrics::write(const std::string& file, const CRepeaters& repeaters) const
+{
+	std::string temp = file + ".tmp";
+
+	FILE* fp = ::fopen(temp.c_str(), "wt");
+	if (fp == NULL) {
+		LogError("Cannot open the metrics file - %s", temp.c_str());
+		return false;
+	}
+
+	::fprintf(fp, "# HELP ysfreflector_relay_latency_seconds Time from receiving a frame to sending it to the last peer.\n");
+	::fprintf(fp, "# TYPE ysfreflector_relay_latency_seconds histogram\n");
+
+	unsigned long long count = 0ULL;
+	for (unsigned int i = 0U; i < LATENCY_BUCKETS - 1U; i++) {
+		count += m_latency.m_buckets[i];
+		::fprintf(fp, "ysfreflector_relay_latency_seconds_bucket{le=\"%g\"} %llu\n", double(LATENCY_BOUNDS[i]) / 1000000.0, count);
+	}
+	::fprintf(fp, "ysfreflector_relay_latency_seconds_bucket{le=\"+Inf\"} %llu\n", m_latency.m_count);
+	::fprintf(fp, "ysfreflector_relay_latency_seconds_sum %.6f\n", double(m_latency.m_sum) / 1000000.0);
+	::fprintf(fp, "ysfreflector_relay_latency_seconds_count %llu\n", m_latency.m_count);
+
+	writeCounter(fp, "packets_in_total", "Frames received from the repeaters.", repeaters, &CYSFRepeater::m_packetsIn, m_packetsIn);
+	writeCounter(fp, "bytes_in_total", "Bytes of frames received from the repeaters.", repeaters, &CYSFRepeater::m_bytesIn, m_bytesIn);
+	writeCounter(fp, "packets_out_total", "Frames relayed to the repeaters.", repeaters, &CYSFRepeater::m_packetsOut, m_packetsOut);
+	writeCounter(fp, "bytes_out_total", "Bytes of frames relayed to the repeaters.", repeaters, &CYSFRepeater::m_bytesOut, m_bytesOut);
+	writeCounter(fp, "polls_total", "Polls received from the repeaters.", repeaters, &CYSFRepeater::m_polls, m_polls);
+
+	::fprintf(fp, "# HELP ysfreflector_frames_dropped_total Frames that were not relayed, or not to every peer.\n");
+	::fprintf(fp, "# TYPE ysfreflector_frames_dropped_total counter\n");
+	::fprintf(fp, "ysfreflector_frames_dropped_total{reason=\"unlinked\"} %llu\n", m_unlinked);
+	::fprintf(fp, "ysfreflector_frames_dropped_total{reason=\"send_error\"} %llu\n", m_sendErrors);
+
+	::fprintf(fp, "# HELP ysfreflector_repeater_poll_interval_seconds Time between the last two polls from a repeater.\n");
+	::fprintf(fp, "# TYPE ysfreflector_repeater_poll_interval_seconds gauge\n");
+	for (unsigned int i = 0U; i < repeaters.size(); i++) {
+		const CYSFRepeater& rpt = repeaters.at(i);
+		::fprintf(fp, "ysfreflector_repeater_poll_interval_seconds");
+		writeLabel(fp, rpt);
+		::fprintf(fp, " %.6f\n", double(rpt.m_pollInterval) / 1000000.0);
+	}
+
+	::fprintf(fp, "# HELP ysfreflector_repeater_last_poll_seconds Time since the last poll from a repeater.\n");
+	::fprintf(fp, "# TYPE ysfreflector_repeater_last_poll_seconds gauge\n");
+	for (unsigned int i = 0U; i < repeaters.size(); i++) {
+		::fprintf(fp, "ysfreflector_repeater_last_poll_seconds");
+		writeLabel(fp, repeaters.at(i));
+		::fprintf(fp, " %u\n", repeaters.getTimer(i));
+	}
+
+	::fprintf(fp, "# HELP ysfreflector_repeaters Linked repeaters and gateways.\n");
+	::fprintf(fp, "# TYPE ysfreflector_repeaters gauge\n");
+	::fprintf(fp, "ysfreflector_repeaters %u\n", repeaters.size());
+
+	bool ret = ::ferror(fp) == 0;
+	ret = ::fclose(fp) == 0 && ret;
+	if (!ret) {
+		LogError("Cannot write the metrics file - %s", temp.c_str());
+		::remove(temp.c_str());
+		return false;
+	}
+
+#if defined(_WIN32) || defined(_WIN64)
+	// rename() will not replace an existing file here
+	::remove(file.c_str());
+#endif
+
+	if (::rename(temp.c_str(), file.c_str()) != 0) {
+		LogError("Cannot rename the metrics file - %s", file.c_str());
+		::remove(temp.c_str());
+		return false;
+	}
+
+	return true;
+}
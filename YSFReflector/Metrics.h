@@ -0,0 +1,92 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#if !defined(Metrics_H)
+#define	Metrics_H
+
+#include "Repeaters.h"
+
+#include <string>
+#include <vector>
+
+// The last bucket is everything above the largest bound
+const unsigned int LATENCY_BUCKETS = 13U;
+
+class CLatencyHistogram {
+public:
+	CLatencyHistogram();
+
+	// The latency is in microseconds
+	void add(unsigned long long latency);
+	void add(const CLatencyHistogram& histogram);
+
+	void clear();
+
+	unsigned long long m_buckets[LATENCY_BUCKETS];
+	unsigned long long m_sum;
+	unsigned long long m_count;
+};
+
+// The counters of one network thread, which it updates without a lock and
+// hands to the reflector every second. The per peer counters are indexed
+// like the thread's copy of the peer list and are handed over before that
+// copy changes. Every member of a room is sent every frame relayed into the
+// room apart from its own, so the traffic out to a peer is worked out from
+// the room totals when they are handed over rather than counted per send.
+class CRelayCounters {
+public:
+	CRelayCounters();
+
+	void reset(unsigned int peers);
+
+	std::vector<unsigned long long> m_packetsIn;
+	std::vector<unsigned long long> m_bytesIn;
+	unsigned long long              m_roomPackets[MAX_ROOMS];
+	unsigned long long              m_roomBytes[MAX_ROOMS];
+	CLatencyHistogram               m_latency;
+	unsigned long long              m_unlinked;
+	unsigned long long              m_sendErrors;
+	bool                            m_changed;
+};
+
+// The reflector wide totals, guarded by the reflector's lock. The per
+// repeater counters live in CYSFRepeater and go when the repeater does.
+class CMetrics {
+public:
+	CMetrics();
+	~CMetrics();
+
+	void add(const CPeerList& peers, const CRelayCounters& counters, CRepeaters& repeaters);
+
+	void pollReceived(CYSFRepeater& repeater, unsigned long long now);
+
+	// Written to a temporary file and renamed, so a reader never sees half of it
+	bool write(const std::string& file, const CRepeaters& repeaters) const;
+
+private:
+	CLatencyHistogram  m_latency;
+	unsigned long long m_packetsIn;
+	unsigned long long m_bytesIn;
+	unsigned long long m_packetsOut;
+	unsigned long long m_bytesOut;
+	unsigned long long m_unlinked;
+	unsigned long long m_sendErrors;
+	unsigned long long m_polls;
+};
+
+#endif
@@ -23,9 +23,13 @@
 #include <cstdio>
 #include <cassert>
 #include <cstring>
+#include <cctype>
+
+const unsigned char POLL_DATA[] = {'Y', 'S', 'F', 'P', 'R', 'E', 'F', 'L', 'E', 'C', 'T', 'O', 'R', ' '};
 
 CNetwork::CNetwork(unsigned int port, const std::string& name, const std::string& description, bool debug) :
 m_socket(port),
+m_peers(),
 m_name(name),
 m_description(description),
 m_callsign(),
@@ -36,18 +40,24 @@ m_status(NULL)
 	m_description.resize(14U, ' ');
 
 	m_status = new unsigned char[50U];
+
+	for (unsigned int i = 0U; i < MAX_ROOMS; i++)
+		m_rooms[i] = NULL;
 }
 
 CNetwork::~CNetwork()
 {
 	delete[] m_status;
+
+	for (unsigned int i = 0U; i < MAX_ROOMS; i++)
+		delete m_rooms[i];
 }
 
-bool CNetwork::open()
+bool CNetwork::open(bool reusePort)
 {
 	::fprintf(stdout, "Opening YSF network connection\n");
 
-	return m_socket.open();
+	return m_socket.open(reusePort);
 }
 
 bool CNetwork::writeData(const unsigned char* data, const in_addr& address, unsigned int port)
@@ -62,28 +72,68 @@ bool CNetwork::writeData(const unsigned char* data, const in_addr& address, unsi
 
 bool CNetwork::writePoll(const in_addr& address, unsigned int port)
 {
-	unsigned char buffer[20U];
-
-	buffer[0] = 'Y';
-	buffer[1] = 'S';
-	buffer[2] = 'F';
-	buffer[3] = 'P';
-
-	buffer[4U]  = 'R';
-	buffer[5U]  = 'E';
-	buffer[6U]  = 'F';
-	buffer[7U]  = 'L';
-	buffer[8U]  = 'E';
-	buffer[9U]  = 'C';
-	buffer[10U] = 'T';
-	buffer[11U] = 'O';
-	buffer[12U] = 'R';
-	buffer[13U] = ' ';
+	if (m_debug)
+		CUtils::dump(1U, "YSF Network Poll Sent", POLL_DATA, 14U);
+
+	return m_socket.write(POLL_DATA, 14U, address, port);
+}
+
+void CNetwork::setPeers(const CPeerList& peers)
+{
+	m_peers.clear();
+
+	for (std::vector<CPeer>::const_iterator it = peers.m_peers.begin(); it != peers.m_peers.end(); ++it)
+		m_peers.add((*it).m_address, (*it).m_port);
+
+	setCount(m_peers.size());
+
+	for (unsigned int i = 1U; i < MAX_ROOMS; i++) {
+		if (m_rooms[i] != NULL)
+			createStatus(m_rooms[i]->m_status, m_rooms[i]->m_name, m_rooms[i]->m_description, peers.m_end[i] - peers.m_start[i]);
+	}
+}
+
+void CNetwork::addRoom(unsigned int dgId, const std::string& name, const std::string& description)
+{
+	assert(dgId > 0U && dgId < MAX_ROOMS);
+
+	delete m_rooms[dgId];
+	m_rooms[dgId] = new CNetworkRoom(name, description);
+
+	createStatus(m_rooms[dgId]->m_status, m_rooms[dgId]->m_name, m_rooms[dgId]->m_description, 0U);
+}
+
+unsigned int CNetwork::writeData(const unsigned char* data, unsigned int start, unsigned int end, unsigned int exclude)
+{
+	assert(data != NULL);
+	assert(start <= end && end <= m_peers.size());
+
+	if (m_debug)
+		CUtils::dump(1U, "YSF Network Data Sent", data, 155U);
+
+	if (exclude < start || exclude >= end)
+		return start == end ? 0U : m_socket.write(data, 155U, m_peers, start, end - start);
+
+	// Send to the peers either side of the excluded one
+	unsigned int sent = 0U;
+	if (exclude > start)
+		sent += m_socket.write(data, 155U, m_peers, start, exclude - start);
+
+	if (exclude + 1U < end)
+		sent += m_socket.write(data, 155U, m_peers, exclude + 1U, end - exclude - 1U);
+
+	return sent;
+}
+
+bool CNetwork::writePoll()
+{
+	if (m_peers.size() == 0U)
+		return true;
 
 	if (m_debug)
-		CUtils::dump(1U, "YSF Network Poll Sent", buffer, 14U);
+		CUtils::dump(1U, "YSF Network Poll Sent", POLL_DATA, 14U);
 
-	return m_socket.write(buffer, 14U, address, port);
+	return m_socket.write(POLL_DATA, 14U, m_peers, 0U, m_peers.size()) == m_peers.size();
 }
 
 unsigned int CNetwork::readData(unsigned char* data, unsigned int length, in_addr& address, unsigned int& port)
@@ -91,31 +141,47 @@ unsigned int CNetwork::readData(unsigned char* data, unsigned int length, in_add
 	assert(data != NULL);
 	assert(length > 0U);
 
-	int len = m_socket.read(data, length, address, port);
-	if (len <= 0)
-		return 0U;
+	for (;;) {
+		int len = m_socket.read(data, length, address, port);
+		if (len <= 0)
+			return 0U;
 
-	// Handle incoming status requests
-	if (::memcmp(data, "YSFS", 4U) == 0) {
-		m_socket.write(m_status, 42U, address, port);
-		return 0U;
-	}
+		// Handle incoming status requests, optionally for a room given by two digits
+		if (::memcmp(data, "YSFS", 4U) == 0) {
+			unsigned char* status = m_status;
+			if (len >= 6 && ::isdigit(data[4U]) && ::isdigit(data[5U])) {
+				unsigned int dgId = (data[4U] - '0') * 10U + (data[5U] - '0');
+				if (m_rooms[dgId] != NULL)
+					status = m_rooms[dgId]->m_status;
+			}
 
-	if (m_debug)
-		CUtils::dump(1U, "YSF Network Data Received", data, len);
+			m_socket.write(status, 42U, address, port);
+			continue;
+		}
+
+		if (m_debug)
+			CUtils::dump(1U, "YSF Network Data Received", data, len);
 
-	return len;
+		return len;
+	}
 }
 
 void CNetwork::setCount(unsigned int count)
 {
+	createStatus(m_status, m_name, m_description, count);
+}
+
+void CNetwork::createStatus(unsigned char* status, const std::string& name, const std::string& description, unsigned int count)
+{
+	assert(status != NULL);
+
 	if (count > 999U)
 		count = 999U;
 
 	unsigned int hash = 0U;
 
-	for (unsigned int i = 0U; i < m_name.size(); i++) {
-		hash += m_name.at(i);
+	for (unsigned int i = 0U; i < name.size(); i++) {
+		hash += name.at(i);
 		hash += (hash << 10);
 		hash ^= (hash >> 6);
 	}
@@ -125,7 +191,12 @@ void CNetwork::setCount(unsigned int count)
 	hash ^= (hash >> 11);
 	hash += (hash << 15);
 
-	::sprintf((char*)m_status, "YSFS%05u%16.16s%14.14s%03u", hash % 100000U, m_name.c_str(), m_description.c_str(), count);
+	::sprintf((char*)status, "YSFS%05u%16.16s%14.14s%03u", hash % 100000U, name.c_str(), description.c_str(), count);
+}
+
+int CNetwork::getFd() const
+{
+	return m_socket.getFd();
 }
 
 void CNetwork::close()
@@ -21,34 +21,66 @@
 
 #include "YSFDefines.h"
 #include "UDPSocket.h"
+#include "Repeaters.h"
 #include "Timer.h"
 
 #include <cstdint>
 #include <string>
 
+class CNetworkRoom {
+public:
+	CNetworkRoom(const std::string& name, const std::string& description) :
+	m_name(name),
+	m_description(description)
+	{
+		m_name.resize(16U, ' ');
+		m_description.resize(14U, ' ');
+	}
+
+	std::string   m_name;
+	std::string   m_description;
+	unsigned char m_status[50U];
+};
+
 class CNetwork {
 public:
 	CNetwork(unsigned int port, const std::string& name, const std::string& description, bool debug);
 	~CNetwork();
 
-	bool open();
+	bool open(bool reusePort = false);
 
 	bool writeData(const unsigned char* data, const in_addr& address, unsigned int port);
 	bool writePoll(const in_addr& address, unsigned int port);
 
+	// The peer list mirrors the given snapshot, index for index
+	void setPeers(const CPeerList& peers);
+
+	// Returns the number of peers that the data was sent to
+	unsigned int writeData(const unsigned char* data, unsigned int start, unsigned int end, unsigned int exclude);
+	bool writePoll();
+
 	unsigned int readData(unsigned char* data, unsigned int length, in_addr& address, unsigned int& port);
 
 	void close();
 
 	void setCount(unsigned int count);
 
+	// An extra room reporting its own status, room 0 is the reflector itself
+	void addRoom(unsigned int dgId, const std::string& name, const std::string& description);
+
+	int  getFd() const;
+
 private:
 	CUDPSocket   m_socket;
+	CUDPBatch    m_peers;
 	std::string  m_name;
 	std::string  m_description;
 	std::string  m_callsign;
 	bool         m_debug;
 	unsigned char* m_status;
+	CNetworkRoom*  m_rooms[MAX_ROOMS];
+
+	static void createStatus(unsigned char* status, const std::string& name, const std::string& description, unsigned int count);
 };
 
 #endif
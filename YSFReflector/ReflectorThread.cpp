@@ -0,0 +1,190 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "ReflectorThread.h"
+#include "YSFReflector.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstring>
+
+CReflectorThread::CReflectorThread(CYSFReflector& reflector, CNetwork* network) :
+CThread(),
+m_reflector(reflector),
+m_network(network),
+m_loop(),
+m_peers(),
+m_generation(0U),
+m_fich(),
+m_counters(),
+m_stopWatch(),
+m_stop(false)
+{
+	assert(network != NULL);
+}
+
+CReflectorThread::~CReflectorThread()
+{
+	delete m_network;
+}
+
+void CReflectorThread::entry()
+{
+	bool ret = m_loop.open();
+	if (ret)
+		ret = m_loop.addSocket(0U, m_network->getFd());
+	if (ret)
+		ret = m_loop.addTimer(1U, 1000U, true);
+	if (!ret) {
+		LogError("Unable to start a network thread");
+		return;
+	}
+
+	m_loop.startTimer(1U);
+
+	// The timer wakes the loop at least once a second to see the stop flag
+	while (!m_stop) {
+		unsigned int events[2U];
+		unsigned int n = m_loop.wait(events, 2U);
+
+		for (unsigned int i = 0U; i < n; i++) {
+			if (events[i] == 0U)
+				readNetwork();
+			else
+				writeMetrics();
+		}
+	}
+
+	m_loop.close();
+}
+
+void CReflectorThread::stop()
+{
+	m_stop = true;
+
+	wait();
+}
+
+void CReflectorThread::readNetwork()
+{
+	refreshPeers();
+
+	unsigned char buffer[200U];
+	in_addr address;
+	unsigned int port;
+
+	// Drain everything that is queued on the socket before waiting again
+	unsigned int length;
+	while ((length = m_network->readData(buffer, 200U, address, port)) > 0U)
+		processData(buffer, length, address, port, m_stopWatch.micros());
+}
+
+void CReflectorThread::writePoll()
+{
+	refreshPeers();
+
+	m_network->writePoll();
+}
+
+void CReflectorThread::writeMetrics()
+{
+	if (!m_counters.m_changed)
+		return;
+
+	m_reflector.metricsReceived(*m_peers, m_counters);
+
+	m_counters.reset(m_peers->size());
+}
+
+int CReflectorThread::getFd() const
+{
+	return m_network->getFd();
+}
+
+void CReflectorThread::refreshPeers()
+{
+	// The common case is a single atomic load that finds nothing has changed
+	if (m_peers && m_reflector.getPeersGeneration() == m_generation)
+		return;
+
+	// The counters are indexed by the old list
+	if (m_peers)
+		writeMetrics();
+
+	m_peers = m_reflector.getPeers(m_generation);
+	m_network->setPeers(*m_peers);
+
+	m_counters.reset(m_peers->size());
+}
+
+void CReflectorThread::processData(const unsigned char* buffer, unsigned int length, const in_addr& address, unsigned int port, unsigned long long received)
+{
+	assert(buffer != NULL);
+
+	if (::memcmp(buffer, "YSFP", 4U) == 0) {
+		m_reflector.pollReceived(std::string((char*)(buffer + 4U), 10U), address, port);
+		m_network->writePoll(address, port);
+
+		// Pick up a newly added repeater before its first frame
+		refreshPeers();
+		return;
+	}
+
+	if (::memcmp(buffer + 0U, "YSFU", 4U) == 0) {
+		m_reflector.unlinkReceived(address, port);
+	} else if (::memcmp(buffer + 0U, "YSFD", 4U) == 0) {
+		unsigned int n = m_peers->find(address, port);
+		if (n == REPEATER_NOT_FOUND) {
+			m_counters.m_unlinked++;
+			m_counters.m_changed = true;
+			return;
+		}
+
+		unsigned int room = m_peers->m_peers.at(n).m_room;
+
+		// A gateway moves to the room of the DG-ID it transmits on, frames
+		// with a damaged FICH stay in the room it is already in
+		if (m_reflector.hasRooms() && m_fich.decode(buffer + 35U)) {
+			unsigned int dgId = m_reflector.getRoom(m_fich.getDGId());
+			if (dgId != room) {
+				m_reflector.roomChanged(address, port, dgId);
+				refreshPeers();
+
+				n = m_peers->find(address, port);
+				if (n == REPEATER_NOT_FOUND)
+					return;
+
+				room = m_peers->m_peers.at(n).m_room;
+			}
+		}
+
+		m_reflector.dataReceived(buffer, room);
+
+		unsigned int sent = m_network->writeData(buffer, m_peers->m_start[room], m_peers->m_end[room], n);
+
+		unsigned int peers = m_peers->m_end[room] - m_peers->m_start[room] - 1U;
+
+		m_counters.m_packetsIn[n]++;
+		m_counters.m_bytesIn[n] += length;
+		m_counters.m_roomPackets[room]++;
+		m_counters.m_roomBytes[room] += length;
+		m_counters.m_sendErrors += peers - sent;
+		m_counters.m_latency.add(m_stopWatch.micros() - received);
+		m_counters.m_changed = true;
+	}
+}
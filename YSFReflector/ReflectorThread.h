@@ -0,0 +1,72 @@
+/*
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#if !defined(ReflectorThread_H)
+#define	ReflectorThread_H
+
+#include "EventLoop.h"
+#include "Repeaters.h"
+#include "Network.h"
+#include "Metrics.h"
+#include "StopWatch.h"
+#include "YSFFICH.h"
+#include "Thread.h"
+
+#include <atomic>
+#include <memory>
+
+class CYSFReflector;
+
+// Owns one socket on the reflector port. The first one is serviced by the
+// main thread's event loop, any others run their own loop on a thread of
+// their own. Each keeps a private copy of the peer list for sendmmsg() that
+// is refreshed when the reflector publishes a new one.
+class CReflectorThread : public CThread {
+public:
+	CReflectorThread(CYSFReflector& reflector, CNetwork* network);
+	virtual ~CReflectorThread();
+
+	virtual void entry();
+
+	// Only for a thread started with run(), waits for it to finish
+	void stop();
+
+	void readNetwork();
+	void writePoll();
+
+	// Hands the counters gathered since the last call to the reflector
+	void writeMetrics();
+
+	int  getFd() const;
+
+private:
+	CYSFReflector&                   m_reflector;
+	CNetwork*                        m_network;
+	CEventLoop                       m_loop;
+	std::shared_ptr<const CPeerList> m_peers;
+	unsigned int                     m_generation;
+	CYSFFICH                         m_fich;
+	CRelayCounters                   m_counters;
+	CStopWatch                       m_stopWatch;
+	std::atomic<bool>                m_stop;
+
+	void refreshPeers();
+	void processData(const unsigned char* buffer, unsigned int length, const in_addr& address, unsigned int port, unsigned long long received);
+};
+
+#endif
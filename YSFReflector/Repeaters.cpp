@@ -0,0 +1,263 @@
+/*
+*   Copyright (C) 2016,2018 by Jonathan Naylor G4KLX
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "Repeaters.h"
+
+#include <cassert>
+
+const unsigned int WHEEL_SLOTS = 64U;
+
+static unsigned long long key(const in_addr& address, unsigned int port)
+{
+	return ((unsigned long long)address.s_addr << 16) | (port & 0xFFFFU);
+}
+
+CPeerList::CPeerList() :
+m_peers(),
+m_index()
+{
+	for (unsigned int i = 0U; i < MAX_ROOMS; i++) {
+		m_start[i] = 0U;
+		m_end[i]   = 0U;
+	}
+}
+
+CPeerList::~CPeerList()
+{
+}
+
+unsigned int CPeerList::find(const in_addr& address, unsigned int port) const
+{
+	std::unordered_map<unsigned long long, unsigned int>::const_iterator it = m_index.find(key(address, port));
+	if (it == m_index.end())
+		return REPEATER_NOT_FOUND;
+
+	return it->second;
+}
+
+unsigned int CPeerList::size() const
+{
+	return m_peers.size();
+}
+
+CRepeaters::CRepeaters(unsigned int timeout) :
+m_repeaters(),
+m_index(),
+m_timeout(timeout * 1000U),
+m_wheel(WHEEL_SLOTS),
+m_expired(),
+m_now(0ULL),
+m_tick(0ULL),
+m_generation(0U)
+{
+	assert(timeout > 0U);
+}
+
+CRepeaters::~CRepeaters()
+{
+}
+
+unsigned int CRepeaters::find(const in_addr& address, unsigned int port) const
+{
+	std::unordered_map<unsigned long long, unsigned int>::const_iterator it = m_index.find(key(address, port));
+	if (it == m_index.end())
+		return REPEATER_NOT_FOUND;
+
+	return it->second;
+}
+
+unsigned int CRepeaters::add(const std::string& callsign, const in_addr& address, unsigned int port)
+{
+	unsigned int n = m_repeaters.size();
+
+	CYSFRepeater rpt;
+	rpt.m_callsign   = callsign;
+	rpt.m_address    = address;
+	rpt.m_port       = port;
+	rpt.m_lastPoll   = m_now;
+	rpt.m_generation = ++m_generation;
+	m_repeaters.push_back(rpt);
+
+	unsigned long long k = key(address, port);
+	m_index[k] = n;
+
+	schedule(CWheelEntry(k, rpt.m_generation), m_now + m_timeout);
+
+	return n;
+}
+
+void CRepeaters::remove(unsigned int n)
+{
+	assert(n < m_repeaters.size());
+
+	m_index.erase(key(m_repeaters[n].m_address, m_repeaters[n].m_port));
+
+	unsigned int last = m_repeaters.size() - 1U;
+	if (n != last) {
+		m_repeaters[n] = m_repeaters[last];
+		m_index[key(m_repeaters[n].m_address, m_repeaters[n].m_port)] = n;
+	}
+
+	m_repeaters.pop_back();
+}
+
+void CRepeaters::refresh(unsigned int n)
+{
+	assert(n < m_repeaters.size());
+
+	m_repeaters[n].m_lastPoll = m_now;
+}
+
+void CRepeaters::setRoom(unsigned int n, unsigned int room)
+{
+	assert(n < m_repeaters.size());
+	assert(room < MAX_ROOMS);
+
+	m_repeaters[n].m_room = room;
+}
+
+void CRepeaters::clock(unsigned int ms)
+{
+	m_now += ms;
+
+	unsigned long long current = m_now / 1000ULL;
+
+	// After a long stall visiting every slot once is enough
+	if (current >= m_tick + WHEEL_SLOTS)
+		m_tick = current - WHEEL_SLOTS + 1ULL;
+
+	while (m_tick <= current) {
+		std::vector<CWheelEntry> slot;
+		slot.swap(m_wheel[m_tick % WHEEL_SLOTS]);
+
+		for (std::vector<CWheelEntry>::const_iterator it = slot.begin(); it != slot.end(); ++it) {
+			// Entries for repeaters that have since unlinked are dropped here
+			unsigned int n = lookup(*it);
+			if (n == REPEATER_NOT_FOUND)
+				continue;
+
+			unsigned long long deadline = m_repeaters[n].m_lastPoll + m_timeout;
+			if (deadline <= m_now)
+				m_expired.push_back(*it);
+			else
+				schedule(*it, deadline);
+		}
+
+		m_tick++;
+	}
+}
+
+unsigned int CRepeaters::getExpired()
+{
+	while (!m_expired.empty()) {
+		CWheelEntry entry = m_expired.back();
+		m_expired.pop_back();
+
+		unsigned int n = lookup(entry);
+		if (n != REPEATER_NOT_FOUND)
+			return n;
+	}
+
+	return REPEATER_NOT_FOUND;
+}
+
+void CRepeaters::schedule(const CWheelEntry& entry, unsigned long long deadline)
+{
+	unsigned long long tick = deadline / 1000ULL;
+
+	// Never put it into the slot being processed, it wouldn't be seen for a whole turn
+	if (tick <= m_tick)
+		tick = m_tick + 1ULL;
+
+	m_wheel[tick % WHEEL_SLOTS].push_back(entry);
+}
+
+unsigned int CRepeaters::lookup(const CWheelEntry& entry) const
+{
+	std::unordered_map<unsigned long long, unsigned int>::const_iterator it = m_index.find(entry.m_key);
+	if (it == m_index.end())
+		return REPEATER_NOT_FOUND;
+
+	// The same address may have unlinked and linked again since the entry was made
+	if (m_repeaters[it->second].m_generation != entry.m_generation)
+		return REPEATER_NOT_FOUND;
+
+	return it->second;
+}
+
+CYSFRepeater& CRepeaters::at(unsigned int n)
+{
+	assert(n < m_repeaters.size());
+
+	return m_repeaters[n];
+}
+
+const CYSFRepeater& CRepeaters::at(unsigned int n) const
+{
+	assert(n < m_repeaters.size());
+
+	return m_repeaters[n];
+}
+
+unsigned int CRepeaters::size() const
+{
+	return m_repeaters.size();
+}
+
+void CRepeaters::getPeers(CPeerList& peers) const
+{
+	// A counting sort by room
+	unsigned int count[MAX_ROOMS];
+	for (unsigned int i = 0U; i < MAX_ROOMS; i++)
+		count[i] = 0U;
+
+	for (std::vector<CYSFRepeater>::const_iterator it = m_repeaters.begin(); it != m_repeaters.end(); ++it)
+		count[(*it).m_room]++;
+
+	unsigned int start = 0U;
+	for (unsigned int i = 0U; i < MAX_ROOMS; i++) {
+		peers.m_start[i] = start;
+		peers.m_end[i]   = start;
+		start += count[i];
+	}
+
+	in_addr none;
+	none.s_addr = INADDR_NONE;
+
+	peers.m_peers.assign(m_repeaters.size(), CPeer(none, 0U, 0U));
+	peers.m_index.clear();
+
+	for (std::vector<CYSFRepeater>::const_iterator it = m_repeaters.begin(); it != m_repeaters.end(); ++it) {
+		unsigned int n = peers.m_end[(*it).m_room]++;
+		peers.m_peers[n] = CPeer((*it).m_address, (*it).m_port, (*it).m_room);
+		peers.m_index[key((*it).m_address, (*it).m_port)] = n;
+	}
+}
+
+unsigned int CRepeaters::getTimer(unsigned int n) const
+{
+	assert(n < m_repeaters.size());
+
+	return (unsigned int)((m_now - m_repeaters[n].m_lastPoll) / 1000ULL);
+}
+
+unsigned int CRepeaters::getTimeout() const
+{
+	return m_timeout / 1000U;
+}
@@ -0,0 +1,167 @@
+/*
+*   Copyright (C) 2016,2018 by Jonathan Naylor G4KLX
+*   Copyright (C) 2026 by agent
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#if !defined(Repeaters_H)
+#define	Repeaters_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <netinet/in.h>
+#else
+#include <winsock.h>
+#endif
+
+class CYSFRepeater {
+public:
+	CYSFRepeater() :
+	m_callsign(),
+	m_address(),
+	m_port(0U),
+	m_room(0U),
+	m_lastPoll(0ULL),
+	m_generation(0U),
+	m_polls(0ULL),
+	m_pollTime(0ULL),
+	m_pollInterval(0ULL),
+	m_packetsIn(0ULL),
+	m_bytesIn(0ULL),
+	m_packetsOut(0ULL),
+	m_bytesOut(0ULL)
+	{
+	}
+
+	std::string        m_callsign;
+	in_addr            m_address;
+	unsigned int       m_port;
+	unsigned int       m_room;
+	unsigned long long m_lastPoll;
+	unsigned int       m_generation;
+
+	// For the metrics, the times are in microseconds
+	unsigned long long m_polls;
+	unsigned long long m_pollTime;
+	unsigned long long m_pollInterval;
+	unsigned long long m_packetsIn;
+	unsigned long long m_bytesIn;
+	unsigned long long m_packetsOut;
+	unsigned long long m_bytesOut;
+};
+
+class CWheelEntry {
+public:
+	CWheelEntry(unsigned long long key, unsigned int generation) :
+	m_key(key),
+	m_generation(generation)
+	{
+	}
+
+	unsigned long long m_key;
+	unsigned int       m_generation;
+};
+
+const unsigned int REPEATER_NOT_FOUND = 0xFFFFFFFFU;
+
+// Rooms are numbered by DG-ID, which is seven bits in the FICH
+const unsigned int MAX_ROOMS = 128U;
+
+class CPeer {
+public:
+	CPeer(const in_addr& address, unsigned int port, unsigned int room) :
+	m_address(address),
+	m_port(port),
+	m_room(room)
+	{
+	}
+
+	in_addr      m_address;
+	unsigned int m_port;
+	unsigned int m_room;
+};
+
+// An immutable copy of the repeater addresses that the network threads share
+// without taking a lock. The peers are grouped by room, so the members of a
+// room are the contiguous range m_start[room] to m_end[room].
+class CPeerList {
+public:
+	CPeerList();
+	~CPeerList();
+
+	unsigned int find(const in_addr& address, unsigned int port) const;
+
+	unsigned int size() const;
+
+	std::vector<CPeer>                                   m_peers;
+	std::unordered_map<unsigned long long, unsigned int> m_index;
+	unsigned int                                         m_start[MAX_ROOMS];
+	unsigned int                                         m_end[MAX_ROOMS];
+};
+
+// The linked repeaters are held in a dense array, with a hash of address and
+// port to array index. Removal moves the last repeater into the hole, so the
+// index of a repeater is only stable until the next removal.
+//
+// Expiry uses a hashed timing wheel of one second slots. A poll only updates
+// the repeater's last poll time, the wheel entry is moved lazily when its slot
+// comes round and the repeater turns out to still be alive.
+class CRepeaters {
+public:
+	CRepeaters(unsigned int timeout);
+	~CRepeaters();
+
+	unsigned int find(const in_addr& address, unsigned int port) const;
+
+	unsigned int add(const std::string& callsign, const in_addr& address, unsigned int port);
+	void remove(unsigned int n);
+
+	void refresh(unsigned int n);
+	void setRoom(unsigned int n, unsigned int room);
+
+	void clock(unsigned int ms);
+
+	// Returns the index of a repeater that has timed out, or REPEATER_NOT_FOUND
+	unsigned int getExpired();
+
+	CYSFRepeater& at(unsigned int n);
+	const CYSFRepeater& at(unsigned int n) const;
+
+	unsigned int size() const;
+
+	void getPeers(CPeerList& peers) const;
+
+	unsigned int getTimer(unsigned int n) const;
+	unsigned int getTimeout() const;
+
+private:
+	std::vector<CYSFRepeater>                            m_repeaters;
+	std::unordered_map<unsigned long long, unsigned int> m_index;
+	unsigned int                                         m_timeout;
+	std::vector<std::vector<CWheelEntry> >               m_wheel;
+	std::vector<CWheelEntry>                             m_expired;
+	unsigned long long                                   m_now;
+	unsigned long long                                   m_tick;
+	unsigned int                                         m_generation;
+
+	void schedule(const CWheelEntry& entry, unsigned long long deadline);
+	unsigned int lookup(const CWheelEntry& entry) const;
+};
+
+#endif
@@ -42,6 +42,14 @@ unsigned long long CStopWatch::time() const
 	return (unsigned long long)(now.QuadPart / m_frequencyMS.QuadPart);
 }
 
+unsigned long long CStopWatch::micros() const
+{
+	LARGE_INTEGER now;
+	::QueryPerformanceCounter(&now);
+
+	return (unsigned long long)(now.QuadPart / (m_frequencyS.QuadPart / 1000000ULL));
+}
+
 unsigned long long CStopWatch::start()
 {
 	::QueryPerformanceCounter(&m_start);
@@ -82,6 +90,14 @@ unsigned long long CStopWatch::time() const
 	return now.tv_sec * 1000ULL + now.tv_usec / 1000ULL;
 }
 
+unsigned long long CStopWatch::micros() const
+{
+	struct timespec now;
+	::clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * 1000000ULL + now.tv_nsec / 1000ULL;
+}
+
 unsigned long long CStopWatch::start()
 {
 	struct timespec now;
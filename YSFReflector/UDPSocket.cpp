@@ -24,13 +24,84 @@
 #if !defined(_WIN32) && !defined(_WIN64)
 #include <cerrno>
 #include <cstring>
+#include <fcntl.h>
 #endif
 
 
+#if defined(__linux__)
+// The kernel will not take more than this many messages per sendmmsg() call
+const unsigned int MAX_BATCH = 1024U;
+#endif
+
+// The shortest time between two reports of dropped datagrams, in ms
+const unsigned int DROP_LOG_INTERVAL = 10000U;
+
+CUDPBatch::CUDPBatch() :
+m_addrs()
+#if defined(__linux__)
+,m_msgs(),
+m_iov()
+#endif
+{
+}
+
+CUDPBatch::~CUDPBatch()
+{
+}
+
+void CUDPBatch::add(const in_addr& address, unsigned int port)
+{
+	sockaddr_in addr;
+	::memset(&addr, 0x00, sizeof(sockaddr_in));
+
+	addr.sin_family = AF_INET;
+	addr.sin_addr   = address;
+	addr.sin_port   = htons(port);
+
+#if defined(__linux__)
+	const sockaddr_in* old = m_addrs.empty() ? NULL : &m_addrs[0];
+#endif
+
+	m_addrs.push_back(addr);
+
+#if defined(__linux__)
+	mmsghdr msg;
+	::memset(&msg, 0x00, sizeof(mmsghdr));
+	msg.msg_hdr.msg_name    = &m_addrs.back();
+	msg.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+	msg.msg_hdr.msg_iov     = &m_iov;
+	msg.msg_hdr.msg_iovlen  = 1U;
+	m_msgs.push_back(msg);
+
+	// Message n always points at address n, refresh them if the addresses moved
+	if (old != NULL && old != &m_addrs[0]) {
+		for (unsigned int i = 0U; i < m_msgs.size(); i++)
+			m_msgs[i].msg_hdr.msg_name = &m_addrs[i];
+	}
+#endif
+}
+
+void CUDPBatch::clear()
+{
+	m_addrs.clear();
+
+#if defined(__linux__)
+	m_msgs.clear();
+#endif
+}
+
+unsigned int CUDPBatch::size() const
+{
+	return m_addrs.size();
+}
+
 CUDPSocket::CUDPSocket(const std::string& address, unsigned int port) :
 m_address(address),
 m_port(port),
-m_fd(-1)
+m_fd(-1),
+m_dropped(0U),
+m_dropLogged(false),
+m_dropWatch()
 {
 	assert(!address.empty());
 
@@ -45,7 +116,10 @@ m_fd(-1)
 CUDPSocket::CUDPSocket(unsigned int port) :
 m_address(),
 m_port(port),
-m_fd(-1)
+m_fd(-1),
+m_dropped(0U),
+m_dropLogged(false),
+m_dropWatch()
 {
 #if defined(_WIN32) || defined(_WIN64)
 	WSAData data;
@@ -102,7 +176,7 @@ in_addr CUDPSocket::lookup(const std::string& hostname)
 #endif
 }
 
-bool CUDPSocket::open()
+bool CUDPSocket::open(bool reusePort)
 {
 	m_fd = ::socket(PF_INET, SOCK_DGRAM, 0);
 	if (m_fd < 0) {
@@ -114,6 +188,15 @@ bool CUDPSocket::open()
 		return false;
 	}
 
+#if !defined(_WIN32) && !defined(_WIN64)
+	// Reads are driven by the event loop, so never block in recvfrom()
+	int flags = ::fcntl(m_fd, F_GETFL, 0);
+	if (flags == -1 || ::fcntl(m_fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+		LogError("Cannot set the UDP socket non-blocking, err: %d", errno);
+		return false;
+	}
+#endif
+
 	if (m_port > 0U) {
 		sockaddr_in addr;
 		::memset(&addr, 0x00, sizeof(sockaddr_in));
@@ -143,6 +226,19 @@ bool CUDPSocket::open()
 			return false;
 		}
 
+		if (reusePort) {
+#if defined(SO_REUSEPORT)
+			// Let several sockets share the port, the kernel spreads the peers across them
+			if (::setsockopt(m_fd, SOL_SOCKET, SO_REUSEPORT, (char *)&reuse, sizeof(reuse)) == -1) {
+				LogError("Cannot set the UDP socket port reuse option, err: %d", errno);
+				return false;
+			}
+#else
+			LogError("Sharing a UDP port between sockets is not supported on this platform");
+			return false;
+#endif
+		}
+
 		if (::bind(m_fd, (sockaddr*)&addr, sizeof(sockaddr_in)) == -1) {
 #if defined(_WIN32) || defined(_WIN64)
 			LogError("Cannot bind the UDP address, err: %lu", ::GetLastError());
@@ -161,6 +257,7 @@ int CUDPSocket::read(unsigned char* buffer, unsigned int length, in_addr& addres
 	assert(buffer != NULL);
 	assert(length > 0U);
 
+#if defined(_WIN32) || defined(_WIN64)
 	// Check that the readfrom() won't block
 	fd_set readFds;
 	FD_ZERO(&readFds);
@@ -187,6 +284,7 @@ int CUDPSocket::read(unsigned char* buffer, unsigned int length, in_addr& addres
 
 	if (ret == 0)
 		return 0;
+#endif
 
 	sockaddr_in addr;
 #if defined(_WIN32) || defined(_WIN64)
@@ -199,6 +297,8 @@ int CUDPSocket::read(unsigned char* buffer, unsigned int length, in_addr& addres
 	int len = ::recvfrom(m_fd, (char*)buffer, length, 0, (sockaddr *)&addr, &size);
 #else
 	ssize_t len = ::recvfrom(m_fd, (char*)buffer, length, 0, (sockaddr *)&addr, &size);
+	if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		return 0;
 #endif
 	if (len <= 0) {
 #if defined(_WIN32) || defined(_WIN64)
@@ -252,6 +352,77 @@ bool CUDPSocket::write(const unsigned char* buffer, unsigned int length, const i
 	return true;
 }
 
+unsigned int CUDPSocket::write(const unsigned char* buffer, unsigned int length, CUDPBatch& batch, unsigned int start, unsigned int count)
+{
+	assert(buffer != NULL);
+	assert(length > 0U);
+	assert(start + count <= batch.size());
+
+	unsigned int sent = 0U;
+
+#if defined(__linux__)
+	batch.m_iov.iov_base = (void*)buffer;
+	batch.m_iov.iov_len  = length;
+
+	unsigned int end = start + count;
+	while (start < end) {
+		unsigned int n = end - start;
+		if (n > MAX_BATCH)
+			n = MAX_BATCH;
+
+		int ret = ::sendmmsg(m_fd, &batch.m_msgs[start], n, 0);
+		if (ret <= 0) {
+			// The send buffer is full, so the rest of the batch would fail too
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+				dropped(end - start);
+				break;
+			}
+
+			LogError("Error returned from sendmmsg, err: %d", errno);
+			// Skip the message that failed and carry on with the rest
+			start++;
+			continue;
+		}
+
+		for (int i = 0; i < ret; i++) {
+			if (batch.m_msgs[start + i].msg_len == length)
+				sent++;
+		}
+
+		start += ret;
+	}
+#else
+	for (unsigned int i = start; i < start + count; i++) {
+		const sockaddr_in& addr = batch.m_addrs[i];
+
+		if (write(buffer, length, addr.sin_addr, ntohs(addr.sin_port)))
+			sent++;
+	}
+#endif
+
+	return sent;
+}
+
+// Reported at most once every DROP_LOG_INTERVAL
+void CUDPSocket::dropped(unsigned int count)
+{
+	m_dropped += count;
+
+	if (m_dropLogged && m_dropWatch.elapsed() < DROP_LOG_INTERVAL)
+		return;
+
+	LogWarning("The socket send buffer is full, %u datagrams dropped", m_dropped);
+
+	m_dropped    = 0U;
+	m_dropLogged = true;
+	m_dropWatch.start();
+}
+
+int CUDPSocket::getFd() const
+{
+	return m_fd;
+}
+
 void CUDPSocket::close()
 {
 #if defined(_WIN32) || defined(_WIN64)
@@ -19,7 +19,10 @@
 #ifndef UDPSocket_H
 #define UDPSocket_H
 
+#include "StopWatch.h"
+
 #include <string>
+#include <vector>
 
 #if !defined(_WIN32) && !defined(_WIN64)
 #include <netdb.h>
@@ -34,25 +37,60 @@
 #include <winsock.h>
 #endif
 
+// A list of destinations for CUDPSocket::write(), with the sendmmsg()
+// headers prebuilt so that a fan-out needs no per-peer setup.
+class CUDPBatch {
+public:
+	CUDPBatch();
+	~CUDPBatch();
+
+	void add(const in_addr& address, unsigned int port);
+	void clear();
+
+	unsigned int size() const;
+
+private:
+	friend class CUDPSocket;
+
+	std::vector<sockaddr_in> m_addrs;
+#if defined(__linux__)
+	std::vector<mmsghdr>     m_msgs;
+	iovec                    m_iov;
+#endif
+
+	CUDPBatch(const CUDPBatch&);
+	CUDPBatch& operator=(const CUDPBatch&);
+};
+
 class CUDPSocket {
 public:
 	CUDPSocket(const std::string& address, unsigned int port = 0U);
 	CUDPSocket(unsigned int port = 0U);
 	~CUDPSocket();
 
-	bool open();
+	bool open(bool reusePort = false);
 
 	int  read(unsigned char* buffer, unsigned int length, in_addr& address, unsigned int& port);
 	bool write(const unsigned char* buffer, unsigned int length, const in_addr& address, unsigned int port);
+	// Returns the number of datagrams that were sent. When the send buffer is
+	// full the rest of the batch is dropped, and counted.
+	unsigned int write(const unsigned char* buffer, unsigned int length, CUDPBatch& batch, unsigned int start, unsigned int count);
 
 	void close();
 
+	int  getFd() const;
+
 	static in_addr lookup(const std::string& hostName);
 
 private:
 	std::string    m_address;
 	unsigned short m_port;
 	int            m_fd;
+	unsigned int   m_dropped;
+	bool           m_dropLogged;
+	CStopWatch     m_dropWatch;
+
+	void dropped(unsigned int count);
 };
 
 #endif
@@ -0,0 +1,262 @@
+/*
+ *   Copyright (C) 2026 by agent
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks CYSFConvolution against the scalar Viterbi decoder it replaced, kept
+// here as it was, on the same input. The input is pseudo random, the same
+// every run, and is either random bits or a coded random message with errors
+// put in, of every length up to the longest the decoder takes. The Makefile
+// links it once with the SSE2 decoder and once with the scalar one. Any
+// difference is reported and fails the run.
+
+#include "YSFConvolution.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const unsigned int DEFAULT_FRAMES = 200000U;
+
+const unsigned int MAX_BYTES = (YSF_CONVOLUTION_MAX_STEPS * 2U + 7U) / 8U;
+
+const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
+
+#define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
+#define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
+
+const uint8_t BRANCH_TABLE1[] = {0U, 0U, 0U, 0U, 1U, 1U, 1U, 1U};
+const uint8_t BRANCH_TABLE2[] = {0U, 1U, 1U, 0U, 0U, 1U, 1U, 0U};
+
+const unsigned int NUM_OF_STATES_D2 = 8U;
+const unsigned int NUM_OF_STATES = 16U;
+const uint32_t     M = 2U;
+const unsigned int K = 5U;
+
+// The decoder before SSE2
+class COldConvolution {
+public:
+	COldConvolution() :
+	m_metrics1(NULL),
+	m_metrics2(NULL),
+	m_oldMetrics(NULL),
+	m_newMetrics(NULL),
+	m_decisions(NULL),
+	m_dp(NULL)
+	{
+		m_metrics1  = new uint16_t[16U];
+		m_metrics2  = new uint16_t[16U];
+		m_decisions = new uint64_t[180U];
+	}
+
+	~COldConvolution()
+	{
+		delete[] m_metrics1;
+		delete[] m_metrics2;
+		delete[] m_decisions;
+	}
+
+	void start()
+	{
+		::memset(m_metrics1, 0x00U, NUM_OF_STATES * sizeof(uint16_t));
+		::memset(m_metrics2, 0x00U, NUM_OF_STATES * sizeof(uint16_t));
+
+		m_oldMetrics = m_metrics1;
+		m_newMetrics = m_metrics2;
+		m_dp = m_decisions;
+	}
+
+	void decode(uint8_t s0, uint8_t s1)
+	{
+		*m_dp = 0U;
+
+		for (uint8_t i = 0U; i < NUM_OF_STATES_D2; i++) {
+			uint8_t j = i * 2U;
+
+			uint16_t metric = (BRANCH_TABLE1[i] ^ s0) + (BRANCH_TABLE2[i] ^ s1);
+
+			uint16_t m0 = m_oldMetrics[i] + metric;
+			uint16_t m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + (M - metric);
+			uint8_t decision0 = (m0 >= m1) ? 1U : 0U;
+			m_newMetrics[j + 0U] = decision0 != 0U ? m1 : m0;
+
+			m0 = m_oldMetrics[i] + (M - metric);
+			m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + metric;
+			uint8_t decision1 = (m0 >= m1) ? 1U : 0U;
+			m_newMetrics[j + 1U] = decision1 != 0U ? m1 : m0;
+
+			*m_dp |= (uint64_t(decision1) << (j + 1U)) | (uint64_t(decision0) << (j + 0U));
+		}
+
+		++m_dp;
+
+		uint16_t* tmp = m_oldMetrics;
+		m_oldMetrics = m_newMetrics;
+		m_newMetrics = tmp;
+	}
+
+	void chainback(unsigned char* out, unsigned int nBits)
+	{
+		uint32_t state = 0U;
+
+		while (nBits-- > 0) {
+			--m_dp;
+
+			uint32_t  i = state >> (9 - K);
+			uint8_t bit = uint8_t(*m_dp >> i) & 1;
+			state = (bit << 7) | (state >> 1);
+
+			WRITE_BIT1(out, nBits, bit != 0U);
+		}
+	}
+
+private:
+	uint16_t* m_metrics1;
+	uint16_t* m_metrics2;
+	uint16_t* m_oldMetrics;
+	uint16_t* m_newMetrics;
+	uint64_t* m_decisions;
+	uint64_t* m_dp;
+};
+
+class CInputSource {
+public:
+	CInputSource() :
+	m_seed(1U)
+	{
+	}
+
+	// Random bits
+	void random(unsigned char* bits, unsigned int length)
+	{
+		for (unsigned int i = 0U; i < length; i++)
+			bits[i] = (unsigned char)(next() >> 16);
+	}
+
+	// A random message of steps - 4 bits and its zero tail, coded, with n bit
+	// errors put in. Every eighth one has a burst of n errors in a row.
+	void coded(const CYSFConvolution& coder, unsigned char* bits, unsigned int steps, unsigned int n)
+	{
+		unsigned char message[MAX_BYTES];
+		::memset(message, 0x00U, MAX_BYTES);
+
+		for (unsigned int i = 0U; i + 4U < steps; i++)
+			WRITE_BIT1(message, i, (next() & 0x10000U) != 0U);
+
+		coder.encode(message, bits, steps);
+
+		unsigned int length = steps * 2U;
+		if ((next() & 0x70000U) == 0U) {
+			unsigned int start = (next() >> 16) % length;
+			for (unsigned int i = start; i < start + n && i < length; i++)
+				WRITE_BIT1(bits, i, READ_BIT1(bits, i) == 0U);
+		} else {
+			for (unsigned int i = 0U; i < n; i++) {
+				unsigned int pos = (next() >> 16) % length;
+				WRITE_BIT1(bits, pos, READ_BIT1(bits, pos) == 0U);
+			}
+		}
+	}
+
+private:
+	unsigned int m_seed;
+
+	unsigned int next()
+	{
+		m_seed = m_seed * 1103515245U + 12345U;
+		return m_seed;
+	}
+};
+
+// Both decoders over the same input, true if the output is the same. As in
+// the FICH and DCH decodes, the tail is usually left out of the output.
+static bool compare(COldConvolution& oldDecoder, CYSFConvolution& newDecoder, const unsigned char* bits, unsigned int steps, bool tail)
+{
+	oldDecoder.start();
+	newDecoder.start();
+
+	for (unsigned int i = 0U; i < steps; i++) {
+		uint8_t s0 = READ_BIT1(bits, i * 2U + 0U) ? 1U : 0U;
+		uint8_t s1 = READ_BIT1(bits, i * 2U + 1U) ? 1U : 0U;
+
+		oldDecoder.decode(s0, s1);
+		newDecoder.decode(s0, s1);
+	}
+
+	unsigned int nBits = (tail || steps <= 4U) ? steps : steps - 4U;
+
+	unsigned char out1[MAX_BYTES], out2[MAX_BYTES];
+	::memset(out1, 0x00U, MAX_BYTES);
+	::memset(out2, 0x00U, MAX_BYTES);
+
+	oldDecoder.chainback(out1, nBits);
+	newDecoder.chainback(out2, nBits);
+
+	return ::memcmp(out1, out2, MAX_BYTES) == 0;
+}
+
+static bool report(const char* name, unsigned int frames, unsigned int differences)
+{
+	::fprintf(stdout, "%-12s %10u frames %10u differences\n", name, frames, differences);
+
+	return differences == 0U;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 2) {
+		::fprintf(stderr, "Usage: ViterbiCheck [frames]\n");
+		return 1;
+	}
+
+	unsigned int frames = DEFAULT_FRAMES;
+	if (argc > 1)
+		frames = (unsigned int)::atoi(argv[1]);
+
+	CInputSource source;
+	COldConvolution oldDecoder;
+	CYSFConvolution newDecoder;
+	bool ok = true;
+
+	unsigned int differences = 0U;
+	for (unsigned int n = 0U; n < frames; n++) {
+		unsigned int steps = 1U + n % YSF_CONVOLUTION_MAX_STEPS;
+
+		unsigned char bits[MAX_BYTES];
+		source.random(bits, MAX_BYTES);
+
+		bool tail = ((n / YSF_CONVOLUTION_MAX_STEPS) & 1U) != 0U;
+		if (!compare(oldDecoder, newDecoder, bits, steps, tail))
+			differences++;
+	}
+	ok = report("random", frames, differences) && ok;
+
+	differences = 0U;
+	for (unsigned int n = 0U; n < frames; n++) {
+		unsigned int steps = 5U + n % (YSF_CONVOLUTION_MAX_STEPS - 4U);
+		unsigned int errors = (n / 2U) % 13U;
+
+		unsigned char bits[MAX_BYTES];
+		source.coded(newDecoder, bits, steps, errors);
+
+		bool tail = ((n / (YSF_CONVOLUTION_MAX_STEPS - 4U)) & 1U) != 0U;
+		if (!compare(oldDecoder, newDecoder, bits, steps, tail))
+			differences++;
+	}
+	ok = report("errors", frames, differences) && ok;
+
+	return ok ? 0 : 1;
+}
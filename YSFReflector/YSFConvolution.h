@@ -0,0 +1,57 @@
+/*
+ *   Copyright (C) 2015,2016,2018 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(YSFConvolution_H)
+#define  YSFConvolution_H
+
+#include "YSFConvolution.h"
+
+#include <cstdint>
+
+// The longest input that can be decoded between start() and chainback()
+const unsigned int YSF_CONVOLUTION_MAX_STEPS = 180U;
+
+// A Viterbi decoder for the K=5 rate 1/2 code used by the FICH and the DCH.
+// Everything it needs is held in the object, so decoding does not allocate.
+class CYSFConvolution {
+public:
+	CYSFConvolution();
+	~CYSFConvolution();
+
+	void start();
+
+	// s0 and s1 are hard decisions, 0 or 1
+	void decode(uint8_t s0, uint8_t s1);
+	void chainback(unsigned char* out, unsigned int nBits);
+
+	void encode(const unsigned char* in, unsigned char* out, unsigned int nBits) const;
+
+private:
+	uint16_t  m_metrics1[16U];
+	uint16_t  m_metrics2[16U];
+	uint16_t* m_oldMetrics;
+	uint16_t* m_newMetrics;
+	uint16_t  m_decisions[YSF_CONVOLUTION_MAX_STEPS];
+	uint16_t* m_dp;
+
+	CYSFConvolution(const CYSFConvolution&);
+	CYSFConvolution& operator=(const CYSFConvolution&);
+};
+
+#endif
+
@@ -17,10 +17,7 @@
 */
 
 #include "YSFReflector.h"
-#include "StopWatch.h"
-#include "Network.h"
 #include "Version.h"
-#include "Thread.h"
 #include "Log.h"
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -44,12 +41,23 @@ const char* DEFAULT_INI_FILE = "/etc/YSFReflector.ini";
 #endif
 
 #include <algorithm>
+#include <cassert>
 #include <cstdio>
 #include <cstdlib>
 #include <cstdarg>
 #include <ctime>
 #include <cstring>
 
+// Each room has its own watchdog, numbered from EVENT_WATCHDOG by DG-ID
+enum EVENT {
+	EVENT_NETWORK,
+	EVENT_POLL,
+	EVENT_DUMP,
+	EVENT_HOUSEKEEPING,
+	EVENT_METRICS,
+	EVENT_WATCHDOG
+};
+
 int main(int argc, char** argv)
 {
 	const char* iniFile = DEFAULT_INI_FILE;
@@ -77,12 +85,27 @@ int main(int argc, char** argv)
 
 CYSFReflector::CYSFReflector(const std::string& file) :
 m_conf(file),
-m_repeaters()
+m_threads(),
+m_loop(),
+m_mutex(),
+m_repeaters(60U),
+m_peers(),
+m_generation(0U),
+m_stopWatch(),
+m_hasRooms(false),
+m_metrics()
 {
+	for (unsigned int i = 0U; i < MAX_ROOMS; i++)
+		m_rooms[i] = NULL;
 }
 
 CYSFReflector::~CYSFReflector()
 {
+	for (std::vector<CReflectorThread*>::iterator it = m_threads.begin(); it != m_threads.end(); ++it)
+		delete *it;
+
+	for (unsigned int i = 0U; i < MAX_ROOMS; i++)
+		delete m_rooms[i];
 }
 
 void CYSFReflector::run()
@@ -162,183 +185,336 @@ void CYSFReflector::run()
 	}
 #endif
 
-	CNetwork network(m_conf.getNetworkPort(), m_conf.getName(), m_conf.getDescription(), m_conf.getNetworkDebug());
+	m_rooms[0U] = new CYSFRoom(0U, "");
+
+	std::vector<CConfRoom> rooms = m_conf.getRooms();
+	for (std::vector<CConfRoom>::const_iterator it = rooms.begin(); it != rooms.end(); ++it) {
+		unsigned int dgId = (*it).m_dgId;
+		if (dgId == 0U || dgId > 99U || m_rooms[dgId] != NULL) {
+			LogWarning("Ignoring the room with DG-ID %u", dgId);
+			continue;
+		}
+
+		char label[20U];
+		::sprintf(label, " on DG-ID %u", dgId);
+		m_rooms[dgId] = new CYSFRoom(dgId, label);
+		m_hasRooms = true;
+
+		LogMessage("Hosting room %s on DG-ID %u", (*it).m_name.c_str(), dgId);
+	}
+
+	unsigned int threads = m_conf.getNetworkThreads();
+	if (threads == 0U)
+		threads = 1U;
+
+	// With more than one thread each has its own socket sharing the port
+	for (unsigned int i = 0U; i < threads; i++) {
+		CNetwork* network = new CNetwork(m_conf.getNetworkPort(), m_conf.getName(), m_conf.getDescription(), m_conf.getNetworkDebug());
+
+		ret = network->open(threads > 1U);
+		if (!ret) {
+			delete network;
+			::LogFinalise();
+			return;
+		}
+
+		for (std::vector<CConfRoom>::const_iterator it = rooms.begin(); it != rooms.end(); ++it) {
+			if (m_rooms[(*it).m_dgId] != NULL && (*it).m_dgId > 0U)
+				network->addRoom((*it).m_dgId, (*it).m_name, (*it).m_description);
+		}
+
+		m_threads.push_back(new CReflectorThread(*this, network));
+	}
 
-	ret = network.open();
+	publishPeers();
+
+	ret = m_loop.open();
+	if (ret)
+		ret = m_loop.addSocket(EVENT_NETWORK, m_threads.at(0U)->getFd());
+	if (ret)
+		ret = m_loop.addTimer(EVENT_POLL, 5000U, true);
+	if (ret)
+		ret = m_loop.addTimer(EVENT_DUMP, 120000U, true);
+	if (ret)
+		ret = m_loop.addTimer(EVENT_HOUSEKEEPING, 1000U, true);
+	if (ret && m_conf.getMetricsEnabled())
+		ret = m_loop.addTimer(EVENT_METRICS, m_conf.getMetricsInterval() > 0U ? m_conf.getMetricsInterval() * 1000U : 1000U, true);
+	for (unsigned int i = 0U; ret && i < MAX_ROOMS; i++) {
+		if (m_rooms[i] != NULL)
+			ret = m_loop.addTimer(EVENT_WATCHDOG + i, 1500U, false);
+	}
 	if (!ret) {
+		m_loop.close();
 		::LogFinalise();
 		return;
 	}
-	
-	network.setCount(0);
-	
-	CStopWatch stopWatch;
-	stopWatch.start();
 
-	CTimer dumpTimer(1000U, 120U);
-	dumpTimer.start();
+	m_stopWatch.start();
 
-	CTimer pollTimer(1000U, 5U);
-	pollTimer.start();
+	m_loop.startTimer(EVENT_POLL);
+	m_loop.startTimer(EVENT_DUMP);
+	m_loop.startTimer(EVENT_HOUSEKEEPING);
+	if (m_conf.getMetricsEnabled())
+		m_loop.startTimer(EVENT_METRICS);
 
 	LogMessage("Starting YSFReflector-%s", VERSION);
 
-	CTimer watchdogTimer(1000U, 0U, 1500U);
+	// The first socket is serviced by this thread, along with the timers
+	for (unsigned int i = 1U; i < m_threads.size(); i++) {
+		ret = m_threads.at(i)->run();
+		if (!ret) {
+			LogError("Unable to start network thread %u", i);
 
-	unsigned char tag[YSF_CALLSIGN_LENGTH];
-	unsigned char src[YSF_CALLSIGN_LENGTH];
-	unsigned char dst[YSF_CALLSIGN_LENGTH];
+			// The threads already running still use the sockets and the log
+			for (unsigned int j = 1U; j < i; j++)
+				m_threads.at(j)->stop();
 
-	for (;;) {
-		unsigned char buffer[200U];
-		in_addr address;
-		unsigned int port;
-
-		unsigned int len = network.readData(buffer, 200U, address, port);
-		if (len > 0U) {
-			CYSFRepeater* rpt = findRepeater(address, port);
-			if (::memcmp(buffer, "YSFP", 4U) == 0) {
-				if (rpt == NULL) {
-					rpt = new CYSFRepeater;
-					rpt->m_callsign = std::string((char*)(buffer + 4U), 10U);
-					rpt->m_address  = address;
-					rpt->m_port     = port;
-					m_repeaters.push_back(rpt);
-					network.setCount(m_repeaters.size());
-					LogMessage("Adding %s (%s:%u)", rpt->m_callsign.c_str(), ::inet_ntoa(address), port);
-				}
-				rpt->m_timer.start();
-				network.writePoll(address, port);
-			} else if (::memcmp(buffer + 0U, "YSFU", 4U) == 0 && rpt != NULL) {
-				LogMessage("Removing %s (%s:%u) unlinked", rpt->m_callsign.c_str(), ::inet_ntoa(address), port);
-				for (std::vector<CYSFRepeater*>::iterator it = m_repeaters.begin(); it != m_repeaters.end(); ++it) {
-					CYSFRepeater* itRpt = *it;
-					if (itRpt->m_address.s_addr == rpt->m_address.s_addr && itRpt->m_port == rpt->m_port) {
-						m_repeaters.erase(it);
-						delete itRpt;
-						break;
-					}
-				}
-				network.setCount(m_repeaters.size());
-			} else if (::memcmp(buffer + 0U, "YSFD", 4U) == 0 && rpt != NULL) {
-				if (!watchdogTimer.isRunning()) {
-					::memcpy(tag, buffer + 4U, YSF_CALLSIGN_LENGTH);
-
-					if (::memcmp(buffer + 14U, "          ", YSF_CALLSIGN_LENGTH) != 0)
-						::memcpy(src, buffer + 14U, YSF_CALLSIGN_LENGTH);
-					else
-						::memcpy(src, "??????????", YSF_CALLSIGN_LENGTH);
-
-					if (::memcmp(buffer + 24U, "          ", YSF_CALLSIGN_LENGTH) != 0)
-						::memcpy(dst, buffer + 24U, YSF_CALLSIGN_LENGTH);
-					else
-						::memcpy(dst, "??????????", YSF_CALLSIGN_LENGTH);
-
-					LogMessage("Received data from %10.10s to %10.10s at %10.10s", src, dst, buffer + 4U);
-				} else {
-					if (::memcmp(tag, buffer + 4U, YSF_CALLSIGN_LENGTH) == 0) {
-						bool changed = false;
-
-						if (::memcmp(buffer + 14U, "          ", YSF_CALLSIGN_LENGTH) != 0 && ::memcmp(src, "??????????", YSF_CALLSIGN_LENGTH) == 0) {
-							::memcpy(src, buffer + 14U, YSF_CALLSIGN_LENGTH);
-							changed = true;
-						}
-
-						if (::memcmp(buffer + 24U, "          ", YSF_CALLSIGN_LENGTH) != 0 && ::memcmp(dst, "??????????", YSF_CALLSIGN_LENGTH) == 0) {
-							::memcpy(dst, buffer + 24U, YSF_CALLSIGN_LENGTH);
-							changed = true;
-						}
-
-						if (changed)
-							LogMessage("Received data from %10.10s to %10.10s at %10.10s", src, dst, buffer + 4U);
-					}
-				}
-
-				watchdogTimer.start();
-
-				for (std::vector<CYSFRepeater*>::const_iterator it = m_repeaters.begin(); it != m_repeaters.end(); ++it) {
-					if ((*it)->m_address.s_addr != address.s_addr || (*it)->m_port != port)
-						network.writeData(buffer, (*it)->m_address, (*it)->m_port);
-				}
-
-				if ((buffer[34U] & 0x01U) == 0x01U) {
-					LogMessage("Received end of transmission");
-					watchdogTimer.stop();
-				}
-			}
+			m_loop.close();
+			::LogFinalise();
+			return;
 		}
+	}
 
-		unsigned int ms = stopWatch.elapsed();
-		stopWatch.start();
+	if (m_threads.size() > 1U)
+		LogMessage("Using %u network threads", m_threads.size());
 
-		pollTimer.clock(ms);
-		if (pollTimer.hasExpired()) {
-			for (std::vector<CYSFRepeater*>::const_iterator it = m_repeaters.begin(); it != m_repeaters.end(); ++it)
-				network.writePoll((*it)->m_address, (*it)->m_port);
-			pollTimer.start();
-		}
+	for (;;) {
+		unsigned int events[10U];
+		unsigned int n = m_loop.wait(events, 10U);
 
-		// Remove any repeaters that haven't reported for a while
-		for (std::vector<CYSFRepeater*>::iterator it = m_repeaters.begin(); it != m_repeaters.end(); ++it)
-			(*it)->m_timer.clock(ms);
-
-		for (std::vector<CYSFRepeater*>::iterator it = m_repeaters.begin(); it != m_repeaters.end(); ++it) {
-			CYSFRepeater* itRpt = *it;
-			if (itRpt->m_timer.hasExpired()) {
-				LogMessage("Removing %s (%s:%u) disappeared", itRpt->m_callsign.c_str(), ::inet_ntoa(itRpt->m_address), itRpt->m_port);
-				m_repeaters.erase(it);
-				delete itRpt;
-				network.setCount(m_repeaters.size());
+		for (unsigned int i = 0U; i < n; i++) {
+			switch (events[i]) {
+			case EVENT_NETWORK:
+				m_threads.at(0U)->readNetwork();
+				break;
+
+			case EVENT_POLL:
+				m_threads.at(0U)->writePoll();
+				break;
+
+			case EVENT_HOUSEKEEPING:
+				clockRepeaters();
+				m_threads.at(0U)->writeMetrics();
+				break;
+
+			case EVENT_METRICS:
+				writeMetrics();
+				break;
+
+			case EVENT_DUMP:
+				dumpRepeaters();
+				break;
+
+			default:
+				if (events[i] >= EVENT_WATCHDOG && events[i] < EVENT_WATCHDOG + MAX_ROOMS)
+					LogMessage("Network watchdog has expired%s", m_rooms[events[i] - EVENT_WATCHDOG]->m_label.c_str());
 				break;
 			}
 		}
+	}
 
-		watchdogTimer.clock(ms);
-		if (watchdogTimer.isRunning() && watchdogTimer.hasExpired()) {
-			LogMessage("Network watchdog has expired");
-			watchdogTimer.stop();
-		}
+	m_loop.close();
+
+	::LogFinalise();
+}
+
+void CYSFReflector::pollReceived(const std::string& callsign, const in_addr& address, unsigned int port)
+{
+	m_mutex.lock();
+
+	unsigned int n = m_repeaters.find(address, port);
+	if (n == REPEATER_NOT_FOUND) {
+		n = m_repeaters.add(callsign, address, port);
+		LogMessage("Adding %s (%s:%u)", callsign.c_str(), ::inet_ntoa(address), port);
+		publishPeers();
+	}
+
+	m_repeaters.refresh(n);
+	m_metrics.pollReceived(m_repeaters.at(n), m_stopWatch.micros());
+
+	m_mutex.unlock();
+}
+
+void CYSFReflector::unlinkReceived(const in_addr& address, unsigned int port)
+{
+	m_mutex.lock();
+
+	unsigned int n = m_repeaters.find(address, port);
+	if (n != REPEATER_NOT_FOUND) {
+		LogMessage("Removing %s (%s:%u) unlinked", m_repeaters.at(n).m_callsign.c_str(), ::inet_ntoa(address), port);
+		m_repeaters.remove(n);
+		publishPeers();
+	}
+
+	m_mutex.unlock();
+}
 
-		dumpTimer.clock(ms);
-		if (dumpTimer.hasExpired()) {
-			dumpRepeaters();
-			dumpTimer.start();
+void CYSFReflector::dataReceived(const unsigned char* buffer, unsigned int room)
+{
+	assert(buffer != NULL);
+	assert(room < MAX_ROOMS && m_rooms[room] != NULL);
+
+	CYSFRoom* r = m_rooms[room];
+	const char* label = r->m_label.c_str();
+
+	m_mutex.lock();
+
+	if (!m_loop.isTimerRunning(EVENT_WATCHDOG + room)) {
+		::memcpy(r->m_tag, buffer + 4U, YSF_CALLSIGN_LENGTH);
+
+		if (::memcmp(buffer + 14U, "          ", YSF_CALLSIGN_LENGTH) != 0)
+			::memcpy(r->m_src, buffer + 14U, YSF_CALLSIGN_LENGTH);
+		else
+			::memcpy(r->m_src, "??????????", YSF_CALLSIGN_LENGTH);
+
+		if (::memcmp(buffer + 24U, "          ", YSF_CALLSIGN_LENGTH) != 0)
+			::memcpy(r->m_dst, buffer + 24U, YSF_CALLSIGN_LENGTH);
+		else
+			::memcpy(r->m_dst, "??????????", YSF_CALLSIGN_LENGTH);
+
+		LogMessage("Received data from %10.10s to %10.10s at %10.10s%s", r->m_src, r->m_dst, buffer + 4U, label);
+	} else {
+		if (::memcmp(r->m_tag, buffer + 4U, YSF_CALLSIGN_LENGTH) == 0) {
+			bool changed = false;
+
+			if (::memcmp(buffer + 14U, "          ", YSF_CALLSIGN_LENGTH) != 0 && ::memcmp(r->m_src, "??????????", YSF_CALLSIGN_LENGTH) == 0) {
+				::memcpy(r->m_src, buffer + 14U, YSF_CALLSIGN_LENGTH);
+				changed = true;
+			}
+
+			if (::memcmp(buffer + 24U, "          ", YSF_CALLSIGN_LENGTH) != 0 && ::memcmp(r->m_dst, "??????????", YSF_CALLSIGN_LENGTH) == 0) {
+				::memcpy(r->m_dst, buffer + 24U, YSF_CALLSIGN_LENGTH);
+				changed = true;
+			}
+
+			if (changed)
+				LogMessage("Received data from %10.10s to %10.10s at %10.10s%s", r->m_src, r->m_dst, buffer + 4U, label);
 		}
+	}
 
-		if (ms < 5U)
-			CThread::sleep(5U);
+	m_loop.startTimer(EVENT_WATCHDOG + room);
+
+	if ((buffer[34U] & 0x01U) == 0x01U) {
+		LogMessage("Received end of transmission%s", label);
+		m_loop.stopTimer(EVENT_WATCHDOG + room);
 	}
 
-	network.close();
+	m_mutex.unlock();
+}
 
-	::LogFinalise();
+void CYSFReflector::roomChanged(const in_addr& address, unsigned int port, unsigned int room)
+{
+	assert(room < MAX_ROOMS && m_rooms[room] != NULL);
+
+	m_mutex.lock();
+
+	unsigned int n = m_repeaters.find(address, port);
+	if (n != REPEATER_NOT_FOUND && m_repeaters.at(n).m_room != room) {
+		LogMessage("Moving %s (%s:%u) to DG-ID %u", m_repeaters.at(n).m_callsign.c_str(), ::inet_ntoa(address), port, room);
+		m_repeaters.setRoom(n, room);
+		publishPeers();
+	}
+
+	m_mutex.unlock();
+}
+
+void CYSFReflector::metricsReceived(const CPeerList& peers, const CRelayCounters& counters)
+{
+	m_mutex.lock();
+	m_metrics.add(peers, counters, m_repeaters);
+	m_mutex.unlock();
 }
 
-CYSFRepeater* CYSFReflector::findRepeater(const in_addr& address, unsigned int port) const
+bool CYSFReflector::hasRooms() const
 {
-	for (std::vector<CYSFRepeater*>::const_iterator it = m_repeaters.begin(); it != m_repeaters.end(); ++it) {
-		if (address.s_addr == (*it)->m_address.s_addr && (*it)->m_port == port)
-			return *it;
+	return m_hasRooms;
+}
+
+unsigned int CYSFReflector::getRoom(unsigned int dgId) const
+{
+	if (dgId < MAX_ROOMS && m_rooms[dgId] != NULL)
+		return dgId;
+
+	return 0U;
+}
+
+unsigned int CYSFReflector::getPeersGeneration() const
+{
+	return m_generation.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<const CPeerList> CYSFReflector::getPeers(unsigned int& generation) const
+{
+	// Read the generation first, the list may be newer but never older
+	generation = m_generation.load(std::memory_order_acquire);
+
+	return std::atomic_load(&m_peers);
+}
+
+void CYSFReflector::publishPeers()
+{
+	// Must be called with m_mutex held, or before the threads are started
+	CPeerList* peers = new CPeerList;
+	m_repeaters.getPeers(*peers);
+
+	// Readers still holding the old list keep it alive until they move on
+	std::atomic_store(&m_peers, std::shared_ptr<const CPeerList>(peers));
+	m_generation.fetch_add(1U, std::memory_order_release);
+}
+
+void CYSFReflector::clockRepeaters()
+{
+	unsigned int ms = m_stopWatch.elapsed();
+	m_stopWatch.start();
+
+	m_mutex.lock();
+
+	m_repeaters.clock(ms);
+
+	// Remove any repeaters that haven't reported for a while
+	bool removed = false;
+	unsigned int n;
+	while ((n = m_repeaters.getExpired()) != REPEATER_NOT_FOUND) {
+		const CYSFRepeater& rpt = m_repeaters.at(n);
+		LogMessage("Removing %s (%s:%u) disappeared", rpt.m_callsign.c_str(), ::inet_ntoa(rpt.m_address), rpt.m_port);
+		m_repeaters.remove(n);
+		removed = true;
 	}
 
-	return NULL;
+	if (removed)
+		publishPeers();
+
+	m_mutex.unlock();
 }
 
-void CYSFReflector::dumpRepeaters() const
+void CYSFReflector::dumpRepeaters()
 {
+	m_mutex.lock();
+
 	if (m_repeaters.size() == 0U) {
 		LogMessage("No repeaters/gateways linked");
+		m_mutex.unlock();
 		return;
 	}
 
 	LogMessage("Currently linked repeaters/gateways:");
 
-	for (std::vector<CYSFRepeater*>::const_iterator it = m_repeaters.begin(); it != m_repeaters.end(); ++it) {
-		std::string callsign = (*it)->m_callsign;
-		in_addr address      = (*it)->m_address;
-		unsigned int port    = (*it)->m_port;
-		unsigned int timer   = (*it)->m_timer.getTimer();
-		unsigned int timeout = (*it)->m_timer.getTimeout();
-		LogMessage("    %s: %s:%u %u/%u", callsign.c_str(), ::inet_ntoa(address), port, timer, timeout);
+	for (unsigned int i = 0U; i < m_repeaters.size(); i++) {
+		const CYSFRepeater& rpt = m_repeaters.at(i);
+		std::string callsign = rpt.m_callsign;
+		in_addr address      = rpt.m_address;
+		unsigned int port    = rpt.m_port;
+		unsigned int timer   = m_repeaters.getTimer(i);
+		unsigned int timeout = m_repeaters.getTimeout();
+		LogMessage("    %s: %s:%u %u/%u%s", callsign.c_str(), ::inet_ntoa(address), port, timer, timeout, m_rooms[rpt.m_room]->m_label.c_str());
 	}
+
+	m_mutex.unlock();
+}
+
+void CYSFReflector::writeMetrics()
+{
+	m_mutex.lock();
+	m_metrics.write(m_conf.getMetricsFile(), m_repeaters);
+	m_mutex.unlock();
 }
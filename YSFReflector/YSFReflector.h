@@ -19,12 +19,19 @@
 #if !defined(YSFReflector_H)
 #define	YSFReflector_H
 
-#include "Timer.h"
+#include "ReflectorThread.h"
+#include "StopWatch.h"
+#include "EventLoop.h"
+#include "Repeaters.h"
+#include "Metrics.h"
+#include "Mutex.h"
 #include "Conf.h"
 
 #include <cstdio>
 #include <string>
 #include <vector>
+#include <memory>
+#include <atomic>
 
 #if !defined(_WIN32) && !defined(_WIN64)
 #include <netdb.h>
@@ -38,20 +45,19 @@
 #include <winsock.h>
 #endif
 
-class CYSFRepeater {
+class CYSFRoom {
 public:
-	CYSFRepeater() :
-	m_callsign(),
-	m_address(),
-	m_port(0U),
-	m_timer(1000U, 60U)
+	CYSFRoom(unsigned int dgId, const std::string& label) :
+	m_dgId(dgId),
+	m_label(label)
 	{
 	}
 
-	std::string  m_callsign;
-	in_addr      m_address;
-	unsigned int m_port;
-	CTimer       m_timer;
+	unsigned int  m_dgId;
+	std::string   m_label;
+	unsigned char m_tag[YSF_CALLSIGN_LENGTH];
+	unsigned char m_src[YSF_CALLSIGN_LENGTH];
+	unsigned char m_dst[YSF_CALLSIGN_LENGTH];
 };
 
 class CYSFReflector
@@ -62,12 +68,37 @@ public:
 
 	void run();
 
+	// These are called from the network threads
+	void pollReceived(const std::string& callsign, const in_addr& address, unsigned int port);
+	void unlinkReceived(const in_addr& address, unsigned int port);
+	void dataReceived(const unsigned char* buffer, unsigned int room);
+	void roomChanged(const in_addr& address, unsigned int port, unsigned int room);
+	void metricsReceived(const CPeerList& peers, const CRelayCounters& counters);
+
+	// Fixed once the threads are running
+	bool hasRooms() const;
+	unsigned int getRoom(unsigned int dgId) const;
+
+	unsigned int getPeersGeneration() const;
+	std::shared_ptr<const CPeerList> getPeers(unsigned int& generation) const;
+
 private:
-	CConf                      m_conf;
-	std::vector<CYSFRepeater*> m_repeaters;
+	CConf                            m_conf;
+	std::vector<CReflectorThread*>   m_threads;
+	CEventLoop                       m_loop;
+	CMutex                           m_mutex;
+	CRepeaters                       m_repeaters;
+	std::shared_ptr<const CPeerList> m_peers;
+	std::atomic<unsigned int>        m_generation;
+	CStopWatch                       m_stopWatch;
+	CYSFRoom*                        m_rooms[MAX_ROOMS];
+	bool                             m_hasRooms;
+	CMetrics                         m_metrics;
 
-	CYSFRepeater* findRepeater(const in_addr& address, unsigned int port) const;
-	void dumpRepeaters() const;
+	void publishPeers();
+	void clockRepeaters();
+	void dumpRepeaters();
+	void writeMetrics();
 };
 
 #endif